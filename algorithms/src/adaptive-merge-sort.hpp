@@ -0,0 +1,439 @@
+#ifndef ADAPTIVE_MERGESORT_HPP
+#define ADAPTIVE_MERGESORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "projection.hpp"
+
+namespace bork_lib
+{
+
+constexpr std::ptrdiff_t min_gallop_default = 7;
+
+/* Returns the index at which key would be inserted before all equal elements of the
+ * sorted range [base, base + len). The search gallops outwards from hint, so it costs
+ * O(log d) comparisons when the answer is d positions from the hint. */
+template<typename RandAccIter, typename T, typename Compare = std::less<>>
+std::ptrdiff_t gallop_left(const T& key, RandAccIter base, std::ptrdiff_t len, std::ptrdiff_t hint,
+                           Compare comp = Compare{})
+{
+    std::ptrdiff_t last_ofs = 0, ofs = 1;
+    if (comp(base[hint], key)) {
+        auto max_ofs = len - hint;
+        while (ofs < max_ofs && comp(base[hint + ofs], key)) {
+            last_ofs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        last_ofs += hint;
+        ofs += hint;
+    } else {
+        auto max_ofs = hint + 1;
+        while (ofs < max_ofs && !comp(base[hint - ofs], key)) {
+            last_ofs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        auto temp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - temp;
+    }
+
+    // base[last_ofs] < key <= base[ofs], so finish with a binary search in between
+    ++last_ofs;
+    while (last_ofs < ofs) {
+        auto mid = last_ofs + (ofs - last_ofs) / 2;
+        if (comp(base[mid], key)) {
+            last_ofs = mid + 1;
+        } else {
+            ofs = mid;
+        }
+    }
+    return ofs;
+}
+
+/* Like gallop_left, but returns the index after all elements equal to key. */
+template<typename RandAccIter, typename T, typename Compare = std::less<>>
+std::ptrdiff_t gallop_right(const T& key, RandAccIter base, std::ptrdiff_t len, std::ptrdiff_t hint,
+                            Compare comp = Compare{})
+{
+    std::ptrdiff_t last_ofs = 0, ofs = 1;
+    if (comp(key, base[hint])) {
+        auto max_ofs = hint + 1;
+        while (ofs < max_ofs && comp(key, base[hint - ofs])) {
+            last_ofs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        auto temp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - temp;
+    } else {
+        auto max_ofs = len - hint;
+        while (ofs < max_ofs && !comp(key, base[hint + ofs])) {
+            last_ofs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        last_ofs += hint;
+        ofs += hint;
+    }
+
+    ++last_ofs;
+    while (last_ofs < ofs) {
+        auto mid = last_ofs + (ofs - last_ofs) / 2;
+        if (comp(key, base[mid])) {
+            ofs = mid;
+        } else {
+            last_ofs = mid + 1;
+        }
+    }
+    return ofs;
+}
+
+/* Extends the sorted prefix [low, start) to [low, high) with stable binary insertion. */
+template<typename RandAccIter, typename Compare = std::less<>>
+void binary_insertion_sort(RandAccIter low, RandAccIter high, RandAccIter start, Compare comp = Compare{})
+{
+    for (auto i = start; i != high; ++i) {
+        auto pivot = std::move(*i);
+        auto pos = std::upper_bound(low, i, pivot, comp);
+        std::move_backward(pos, i, i + 1);
+        *pos = std::move(pivot);
+    }
+}
+
+/* Returns the length of the run that starts at low. A strictly descending run is
+ * reversed in place; requiring strictness keeps the sort stable. */
+template<typename RandAccIter, typename Compare = std::less<>>
+std::ptrdiff_t count_run(RandAccIter low, RandAccIter high, Compare comp = Compare{})
+{
+    auto i = low + 1;
+    if (i == high) {
+        return 1;
+    }
+
+    if (comp(*i, *low)) {
+        for (++i; i != high && comp(*i, *(i - 1)); ++i);
+        std::reverse(low, i);
+    } else {
+        for (++i; i != high && !comp(*i, *(i - 1)); ++i);
+    }
+    return i - low;
+}
+
+/* Returns the minimum run length: n / 2^k rounded up, chosen in [32, 64] so that the
+ * number of runs is a power of two or slightly less. */
+inline std::ptrdiff_t min_run_length(std::ptrdiff_t n)
+{
+    std::ptrdiff_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+/* A natural merge sort in the style of TimSort. */
+template<typename RandAccIter, typename Compare = std::less<>>
+class AdaptiveMergeSort
+{
+private:
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+
+    struct Run
+    {
+        std::ptrdiff_t base;
+        std::ptrdiff_t len;
+    };
+
+    RandAccIter low;
+    Compare comp;
+    std::vector<Run> runs;
+    std::vector<T> temp;
+    std::ptrdiff_t min_gallop = min_gallop_default;
+    void merge_at(std::size_t i);
+    void merge_low(RandAccIter base1, std::ptrdiff_t len1, RandAccIter base2, std::ptrdiff_t len2);
+    void merge_high(RandAccIter base1, std::ptrdiff_t len1, RandAccIter base2, std::ptrdiff_t len2);
+    void merge_collapse();
+
+public:
+    explicit AdaptiveMergeSort(RandAccIter low, Compare comp = Compare{}) : low{low}, comp{std::move(comp)} {}
+    void sort(RandAccIter high);
+};
+
+/* Private function that merges runs i and i + 1 of the stack. */
+template<typename RandAccIter, typename Compare>
+void AdaptiveMergeSort<RandAccIter, Compare>::merge_at(std::size_t i)
+{
+    auto base1 = low + runs[i].base;
+    auto len1 = runs[i].len;
+    auto base2 = low + runs[i + 1].base;
+    auto len2 = runs[i + 1].len;
+    runs[i].len += len2;
+    runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+
+    // elements of run 1 not larger than the head of run 2 are already in place
+    auto k = gallop_right(*base2, base1, len1, 0, comp);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0) {
+        return;
+    }
+
+    // elements of run 2 not smaller than the tail of run 1 are already in place
+    len2 = gallop_left(base1[len1 - 1], base2, len2, len2 - 1, comp);
+    if (len2 == 0) {
+        return;
+    }
+
+    if (len1 <= len2) {
+        merge_low(base1, len1, base2, len2);
+    } else {
+        merge_high(base1, len1, base2, len2);
+    }
+}
+
+/* Private function that merges two adjacent runs, with the shorter first run moved to the
+ * temporary buffer, from the front. Once one run wins min_gallop times in a row, the merge
+ * switches to galloping and moves whole blocks at a time. Requires that the head of run 2
+ * is smaller than the head of run 1 and the tail of run 1 is larger than all of run 2. */
+template<typename RandAccIter, typename Compare>
+void AdaptiveMergeSort<RandAccIter, Compare>::merge_low(RandAccIter base1, std::ptrdiff_t len1,
+                                                        RandAccIter base2, std::ptrdiff_t len2)
+{
+    temp.assign(std::make_move_iterator(base1), std::make_move_iterator(base1 + len1));
+    auto c1 = temp.begin();
+    auto c2 = base2;
+    auto dest = base1;
+
+    *dest++ = std::move(*c2++);
+    bool done = --len2 == 0 || len1 == 1;
+    while (!done) {
+        std::ptrdiff_t count1 = 0, count2 = 0;
+        while ((count1 | count2) < min_gallop) {
+            if (comp(*c2, *c1)) {
+                *dest++ = std::move(*c2++);
+                ++count2;
+                count1 = 0;
+                if (--len2 == 0) {
+                    done = true;
+                    break;
+                }
+            } else {
+                *dest++ = std::move(*c1++);
+                ++count1;
+                count2 = 0;
+                if (--len1 == 1) {
+                    done = true;
+                    break;
+                }
+            }
+        }
+        if (done) {
+            break;
+        }
+
+        ++min_gallop;
+        do {
+            min_gallop -= min_gallop > 1;
+            count1 = gallop_right(*c2, c1, len1, 0, comp);
+            if (count1 != 0) {
+                dest = std::move(c1, c1 + count1, dest);
+                c1 += count1;
+                len1 -= count1;
+                if (len1 <= 1) {
+                    done = true;
+                    break;
+                }
+            }
+            *dest++ = std::move(*c2++);
+            if (--len2 == 0) {
+                done = true;
+                break;
+            }
+
+            count2 = gallop_left(*c1, c2, len2, 0, comp);
+            if (count2 != 0) {
+                dest = std::move(c2, c2 + count2, dest);
+                c2 += count2;
+                len2 -= count2;
+                if (len2 == 0) {
+                    done = true;
+                    break;
+                }
+            }
+            *dest++ = std::move(*c1++);
+            if (--len1 == 1) {
+                done = true;
+                break;
+            }
+        } while (count1 >= min_gallop_default || count2 >= min_gallop_default);
+        ++min_gallop;   // penalize leaving galloping mode
+    }
+
+    if (len1 == 1 && len2 > 0) {
+        dest = std::move(c2, c2 + len2, dest);
+        *dest = std::move(*c1);
+    } else {
+        std::move(c1, c1 + len1, dest);
+    }
+}
+
+/* Private function that mirrors merge_low from the back, with the shorter second run moved
+ * to the temporary buffer. */
+template<typename RandAccIter, typename Compare>
+void AdaptiveMergeSort<RandAccIter, Compare>::merge_high(RandAccIter base1, std::ptrdiff_t len1,
+                                                         RandAccIter base2, std::ptrdiff_t len2)
+{
+    temp.assign(std::make_move_iterator(base2), std::make_move_iterator(base2 + len2));
+    auto run2 = temp.begin();
+
+    // the next output position is always base1[len1 + len2 - 1]
+    base1[len1 + len2 - 1] = std::move(base1[len1 - 1]);
+    bool done = --len1 == 0 || len2 == 1;
+    while (!done) {
+        std::ptrdiff_t count1 = 0, count2 = 0;
+        while ((count1 | count2) < min_gallop) {
+            if (comp(run2[len2 - 1], base1[len1 - 1])) {
+                base1[len1 + len2 - 1] = std::move(base1[len1 - 1]);
+                ++count1;
+                count2 = 0;
+                if (--len1 == 0) {
+                    done = true;
+                    break;
+                }
+            } else {
+                base1[len1 + len2 - 1] = std::move(run2[len2 - 1]);
+                ++count2;
+                count1 = 0;
+                if (--len2 == 1) {
+                    done = true;
+                    break;
+                }
+            }
+        }
+        if (done) {
+            break;
+        }
+
+        ++min_gallop;
+        do {
+            min_gallop -= min_gallop > 1;
+            auto k = gallop_right(run2[len2 - 1], base1, len1, len1 - 1, comp);
+            count1 = len1 - k;
+            if (count1 != 0) {
+                std::move_backward(base1 + k, base1 + len1, base1 + len1 + len2);
+                len1 = k;
+                if (len1 == 0) {
+                    done = true;
+                    break;
+                }
+            }
+            base1[len1 + len2 - 1] = std::move(run2[len2 - 1]);
+            if (--len2 == 1) {
+                done = true;
+                break;
+            }
+
+            k = gallop_left(base1[len1 - 1], run2, len2, len2 - 1, comp);
+            count2 = len2 - k;
+            if (count2 != 0) {
+                std::move_backward(run2 + k, run2 + len2, base1 + len1 + len2);
+                len2 = k;
+                if (len2 <= 1) {
+                    done = true;
+                    break;
+                }
+            }
+            base1[len1 + len2 - 1] = std::move(base1[len1 - 1]);
+            if (--len1 == 0) {
+                done = true;
+                break;
+            }
+        } while (count1 >= min_gallop_default || count2 >= min_gallop_default);
+        ++min_gallop;
+    }
+
+    if (len2 == 1 && len1 > 0) {
+        std::move_backward(base1, base1 + len1, base1 + len1 + 1);
+        *base1 = std::move(run2[0]);
+    } else {
+        std::move(run2, run2 + len2, base1);
+    }
+}
+
+/* Private function that merges runs until the stack invariants hold again: every run is
+ * longer than the next one, and longer than the next two combined. */
+template<typename RandAccIter, typename Compare>
+void AdaptiveMergeSort<RandAccIter, Compare>::merge_collapse()
+{
+    while (runs.size() > 1) {
+        auto n = runs.size() - 2;
+        if ((n > 0 && runs[n - 1].len <= runs[n].len + runs[n + 1].len) ||
+            (n > 1 && runs[n - 2].len <= runs[n - 1].len + runs[n].len)) {
+            if (runs[n - 1].len < runs[n + 1].len) {
+                --n;
+            }
+        } else if (runs[n].len > runs[n + 1].len) {
+            break;
+        }
+        merge_at(n);
+    }
+}
+
+/* Sorts [low, high). */
+template<typename RandAccIter, typename Compare>
+void AdaptiveMergeSort<RandAccIter, Compare>::sort(RandAccIter high)
+{
+    auto n = high - low;
+    auto min_run = min_run_length(n);
+    for (std::ptrdiff_t base = 0; base < n;) {
+        auto len = count_run(low + base, high, comp);
+        if (len < min_run) {
+            auto forced = std::min(min_run, n - base);
+            binary_insertion_sort(low + base, low + base + forced, low + base + len, comp);
+            len = forced;
+        }
+
+        runs.push_back({base, len});
+        merge_collapse();
+        base += len;
+    }
+
+    while (runs.size() > 1) {
+        auto n = runs.size() - 2;
+        if (n > 0 && runs[n - 1].len < runs[n + 1].len) {
+            --n;
+        }
+        merge_at(n);
+    }
+}
+
+/* Stable natural merge sort: finds existing ascending and descending runs, extends short
+ * ones with binary insertion sort and merges them with galloping, so nearly sorted input
+ * takes close to linear time. Ordered by comp applied to the projected elements. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+void adaptive_merge_sort(RandAccIter low, RandAccIter high, Compare comp, Proj proj = Proj{})
+{
+    if (high - low < 2) {
+        return;
+    }
+
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    AdaptiveMergeSort<RandAccIter, decltype(less)>{low, std::move(less)}.sort(high);
+}
+
+template<typename RandAccIter>
+void adaptive_merge_sort(RandAccIter low, RandAccIter high)
+{
+    adaptive_merge_sort(low, high, std::less<>{});
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef ARGSORT_HPP
+#define ARGSORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "introsort.hpp"
+#include "projection.hpp"
+
+namespace bork_lib
+{
+
+/* Indirect sorting. argsort leaves the range alone and returns the permutation that would
+ * sort it, as positions into the range: perm[i] is the position of the i-th smallest
+ * element. Only the indices are moved while sorting, which pays off when the elements are
+ * wide records, and the same permutation can then be applied to every column of a
+ * structure of arrays:
+ *
+ *     auto perm = argsort(keys.begin(), keys.end());
+ *     apply_permutation(perm, keys.begin(), names.begin(), prices.begin()); */
+
+constexpr std::size_t argsort_max_cached_key = 16;
+
+/* Returns the permutation that stably sorts the range, ordered by comp applied to the
+ * projected elements. Small trivially copyable keys are copied next to their index first,
+ * so the sort runs on a compact array; other keys are looked up through the index on
+ * every comparison. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+std::vector<std::size_t> argsort(RandAccIter low, RandAccIter high, Compare comp, Proj proj = Proj{})
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    using Key = std::decay_t<std::invoke_result_t<Proj&, T&>>;
+    auto n = static_cast<std::size_t>(high - low);
+    std::vector<std::size_t> perm(n);
+    if constexpr (std::is_trivially_copyable_v<Key> && sizeof(Key) <= argsort_max_cached_key) {
+        std::vector<std::pair<Key, std::size_t>> keyed;
+        keyed.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keyed.emplace_back(std::invoke(proj, low[static_cast<std::ptrdiff_t>(i)]), i);
+        }
+        introsort(keyed.begin(), keyed.end(), [&comp](const auto& a, const auto& b) {
+            if (std::invoke(comp, a.first, b.first)) {
+                return true;
+            }
+            return !std::invoke(comp, b.first, a.first) && a.second < b.second;   // equal keys keep their order
+        });
+        for (std::size_t i = 0; i < n; ++i) {
+            perm[i] = keyed[i].second;
+        }
+    } else {
+        auto less = make_projected_compare(std::move(comp), std::move(proj));
+        std::iota(perm.begin(), perm.end(), std::size_t{0});
+        introsort(perm.begin(), perm.end(), [low, &less](std::size_t a, std::size_t b) {
+            const auto& x = low[static_cast<std::ptrdiff_t>(a)];
+            const auto& y = low[static_cast<std::ptrdiff_t>(b)];
+            if (less(x, y)) {
+                return true;
+            }
+            return !less(y, x) && a < b;
+        });
+    }
+    return perm;
+}
+
+template<typename RandAccIter>
+std::vector<std::size_t> argsort(RandAccIter low, RandAccIter high)
+{
+    return argsort(low, high, std::less<>{});
+}
+
+/* Rearranges every column so that position i receives the element at perm[i], as returned
+ * by argsort. The columns are given by their first iterator and must hold at least
+ * perm.size() elements. The permutation is applied in place by following its cycles, all
+ * columns in the same pass, so each element is moved once and perm is read once. Throws
+ * std::invalid_argument if perm is not a permutation. */
+template<typename... RandAccIters>
+void apply_permutation(const std::vector<std::size_t>& perm, RandAccIters... columns)
+{
+    auto n = perm.size();
+    std::vector<bool> placed(n, false);
+    for (auto i : perm) {
+        if (i >= n || placed[i]) {
+            throw std::invalid_argument("Not a permutation.");
+        }
+        placed[i] = true;
+    }
+
+    std::fill(placed.begin(), placed.end(), false);
+    for (std::size_t start = 0; start < n; ++start) {
+        if (placed[start] || perm[start] == start) {
+            continue;
+        }
+
+        auto at = [](auto column, std::size_t i) -> decltype(auto) {
+            return column[static_cast<std::ptrdiff_t>(i)];
+        };
+        std::tuple<typename std::iterator_traits<RandAccIters>::value_type...> saved{std::move(at(columns, start))...};
+        auto pos = start;
+        while (perm[pos] != start) {
+            auto next = perm[pos];
+            ((at(columns, pos) = std::move(at(columns, next))), ...);
+            placed[pos] = true;
+            pos = next;
+        }
+        std::apply([&](auto&... values) { ((at(columns, pos) = std::move(values)), ...); }, saved);
+        placed[pos] = true;
+    }
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef BLOCK_MERGE_SORT_HPP
+#define BLOCK_MERGE_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "leaf-sort.hpp"
+#include "projection.hpp"
+
+namespace bork_lib
+{
+
+constexpr std::size_t block_merge_cache_bytes = std::size_t{1} << 14;
+constexpr std::size_t block_merge_max_cache = 512;
+
+/* Returns the number of elements in the fixed cache of block_merge_sort. */
+template<typename T>
+constexpr std::size_t block_merge_cache_size()
+{
+    return std::max<std::size_t>(std::min(block_merge_max_cache, block_merge_cache_bytes / sizeof(T)), 1);
+}
+
+/* Private function that merges [first, middle) and [middle, last) when the left run fits
+ * in the cache: the left run is moved out and merged forward into the gap it left. */
+template<typename RandAccIter, typename CacheIter, typename Compare>
+void merge_forward_from_cache(RandAccIter first, RandAccIter middle, RandAccIter last, CacheIter cache,
+                              Compare comp)
+{
+    auto cache_end = std::move(first, middle, cache);
+    auto out = first;
+    while (cache != cache_end && middle != last) {
+        if (comp(*middle, *cache)) {
+            *out++ = std::move(*middle++);
+        } else {
+            *out++ = std::move(*cache++);
+        }
+    }
+    std::move(cache, cache_end, out);
+}
+
+/* Private function that merges [first, middle) and [middle, last) when the right run fits
+ * in the cache: the right run is moved out and merged backward into the gap it left. */
+template<typename RandAccIter, typename CacheIter, typename Compare>
+void merge_backward_from_cache(RandAccIter first, RandAccIter middle, RandAccIter last, CacheIter cache,
+                               Compare comp)
+{
+    auto cache_end = std::move(middle, last, cache);
+    auto out = last;
+    while (cache != cache_end && middle != first) {
+        if (comp(*(cache_end - 1), *(middle - 1))) {
+            *--out = std::move(*--middle);
+        } else {
+            *--out = std::move(*--cache_end);
+        }
+    }
+    std::move_backward(cache, cache_end, out);
+}
+
+/* Private function that stably merges two adjacent sorted runs in place. Runs that fit in
+ * the cache are merged through it. Otherwise the longer run is split at its middle, the
+ * matching split point of the other run is found by binary search, and a rotation swaps
+ * the two inner pieces, which leaves two independent and smaller merges. */
+template<typename RandAccIter, typename CacheIter, typename Compare>
+void merge_in_place(RandAccIter first, RandAccIter middle, RandAccIter last, CacheIter cache,
+                    std::ptrdiff_t cache_size, Compare comp)
+{
+    while (first != middle && middle != last && comp(*middle, *(middle - 1))) {
+        if (comp(*(last - 1), *first)) {   // the whole right run goes first
+            std::rotate(first, middle, last);
+            return;
+        }
+
+        auto left_size = middle - first;
+        auto right_size = last - middle;
+        if (left_size <= cache_size && left_size <= right_size) {
+            merge_forward_from_cache(first, middle, last, cache, comp);
+            return;
+        }
+        if (right_size <= cache_size) {
+            merge_backward_from_cache(first, middle, last, cache, comp);
+            return;
+        }
+
+        RandAccIter left_cut, right_cut;
+        if (left_size > right_size) {
+            left_cut = first + left_size / 2;
+            right_cut = std::lower_bound(middle, last, *left_cut, comp);
+        } else {
+            right_cut = middle + right_size / 2;
+            left_cut = std::upper_bound(first, middle, *right_cut, comp);
+        }
+        auto new_middle = std::rotate(left_cut, middle, right_cut);
+
+        // recurse on the shorter half and loop on the longer one
+        if (new_middle - first < last - new_middle) {
+            merge_in_place(first, left_cut, new_middle, cache, cache_size, comp);
+            first = new_middle;
+            middle = right_cut;
+        } else {
+            merge_in_place(new_middle, right_cut, last, cache, cache_size, comp);
+            last = new_middle;
+            middle = left_cut;
+        }
+    }
+}
+
+/* Stable merge sort that needs no memory beyond a fixed cache of at most 16 KiB on the
+ * stack, ordered by comp applied to the projected elements. Runs of 16 are insertion
+ * sorted and then merged bottom-up in place. Merges go through the cache when one side
+ * fits and are otherwise split by rotations, as in WikiSort without its internal buffers,
+ * so the worst case is O(n log n) comparisons and O(n log^2 n) moves. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+void block_merge_sort(RandAccIter low, RandAccIter high, Compare comp, Proj proj = Proj{})
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    auto n = static_cast<std::ptrdiff_t>(high - low);
+    for (std::ptrdiff_t i = 0; i < n; i += InsertionLeafSort::max_size) {
+        insertion_sort_move(low + i, low + std::min(i + InsertionLeafSort::max_size, n), less);
+    }
+    if (n <= InsertionLeafSort::max_size) {
+        return;
+    }
+
+    std::array<T, block_merge_cache_size<T>()> cache;
+    auto cache_size = static_cast<std::ptrdiff_t>(cache.size());
+    for (auto width = InsertionLeafSort::max_size; width < n; width *= 2) {
+        for (std::ptrdiff_t i = 0; i + width < n; i += 2 * width) {
+            merge_in_place(low + i, low + i + width, low + std::min(i + 2 * width, n), cache.begin(), cache_size, less);
+        }
+    }
+}
+
+template<typename RandAccIter>
+void block_merge_sort(RandAccIter low, RandAccIter high)
+{
+    block_merge_sort(low, high, std::less<>{});
+}
+
+} // end namespace
+
+#endif
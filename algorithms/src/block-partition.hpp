@@ -0,0 +1,97 @@
+#ifndef BLOCK_PARTITION_HPP
+#define BLOCK_PARTITION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace bork_lib
+{
+
+/* Selects the partition routine used by the quicksort templates. three_way groups the keys
+ * equal to the pivot (see three-way-partition.hpp). */
+enum class PartitionScheme
+{
+    classic, block, three_way
+};
+
+constexpr std::ptrdiff_t partition_block_size = 64;
+
+/* BlockQuicksort partition around the pivot stored at *low. Each side scans a block and
+ * records the offsets of misplaced elements with branch-free index arithmetic, then the
+ * recorded elements are swapped in bulk, so comparison results never feed a branch.
+ * Returns the final position p of the pivot: [low, p) <= pivot <= (p, high). */
+template<typename RandAccIter, typename Compare = std::less<>>
+RandAccIter block_partition(RandAccIter low, RandAccIter high, Compare comp = Compare{})
+{
+    auto pivot = std::move(*low);
+    auto first = low + 1;
+    auto last = high;
+    unsigned char offsets_left[partition_block_size];
+    unsigned char offsets_right[partition_block_size];
+    std::ptrdiff_t num_left = 0, num_right = 0, start_left = 0, start_right = 0;
+
+    while (last - first >= 2 * partition_block_size) {
+        if (num_left == 0) {
+            start_left = 0;
+            for (std::ptrdiff_t i = 0; i < partition_block_size; ++i) {
+                offsets_left[num_left] = static_cast<unsigned char>(i);
+                num_left += !comp(first[i], pivot);
+            }
+        }
+        if (num_right == 0) {
+            start_right = 0;
+            for (std::ptrdiff_t i = 0; i < partition_block_size; ++i) {
+                offsets_right[num_right] = static_cast<unsigned char>(i);
+                num_right += !comp(pivot, *(last - 1 - i));
+            }
+        }
+
+        auto num = std::min(num_left, num_right);
+        for (std::ptrdiff_t k = 0; k < num; ++k) {
+            std::iter_swap(first + offsets_left[start_left + k], last - 1 - offsets_right[start_right + k]);
+        }
+        num_left -= num;
+        num_right -= num;
+        start_left += num;
+        start_right += num;
+        if (num_left == 0) {
+            first += partition_block_size;
+        }
+        if (num_right == 0) {
+            last -= partition_block_size;
+        }
+    }
+
+    // fewer than two blocks remain, so finish with a scalar Hoare scan
+    while (true) {
+        while (first < last && comp(*first, pivot)) {
+            ++first;
+        }
+        while (first < last && comp(pivot, *(last - 1))) {
+            --last;
+        }
+        if (first >= last) {
+            break;
+        }
+        --last;
+        if (first == last) {
+            break;
+        }
+        std::iter_swap(first, last);
+        ++first;
+    }
+
+    auto pivot_pos = first - 1;
+    if (pivot_pos != low) {
+        *low = std::move(*pivot_pos);
+    }
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+} // end namespace
+
+#endif
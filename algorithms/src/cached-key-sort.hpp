@@ -0,0 +1,65 @@
+#ifndef CACHED_KEY_SORT_HPP
+#define CACHED_KEY_SORT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "introsort.hpp"
+
+namespace bork_lib
+{
+
+/* Decorate-sort-undecorate. The projection runs once per element and the (key, index)
+ * pairs are sorted with the given sort, which is called as sort(first, last, compare);
+ * the elements are then moved into their sorted order. Use it when the key is expensive
+ * to compute (parsing, hashing), since the plain projection overloads recompute it on
+ * every comparison. Equal keys keep their original order whichever sort is used. */
+template<typename RandAccIter, typename Compare, typename Proj, typename Sort>
+void cached_key_sort(RandAccIter low, RandAccIter high, Compare comp, Proj proj, Sort sort)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    using Key = std::decay_t<std::invoke_result_t<Proj&, T&>>;
+    auto n = static_cast<std::size_t>(high - low);
+    if (n < 2) {
+        return;
+    }
+
+    std::vector<std::pair<Key, std::size_t>> decorated;
+    decorated.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        decorated.emplace_back(std::invoke(proj, low[static_cast<std::ptrdiff_t>(i)]), i);
+    }
+
+    sort(decorated.begin(), decorated.end(), [&comp](const auto& a, const auto& b) {
+        if (std::invoke(comp, a.first, b.first)) {
+            return true;
+        }
+        if (std::invoke(comp, b.first, a.first)) {
+            return false;
+        }
+        return a.second < b.second;
+    });
+
+    std::vector<T> sorted;
+    sorted.reserve(n);
+    for (const auto& element : decorated) {
+        sorted.push_back(std::move(low[static_cast<std::ptrdiff_t>(element.second)]));
+    }
+    std::move(sorted.begin(), sorted.end(), low);
+}
+
+/* Decorate-sort-undecorate with introsort. */
+template<typename RandAccIter, typename Compare, typename Proj>
+void cached_key_sort(RandAccIter low, RandAccIter high, Compare comp, Proj proj)
+{
+    cached_key_sort(low, high, std::move(comp), std::move(proj), [](auto first, auto last, auto less) {
+        introsort(first, last, less);
+    });
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,314 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "introsort.hpp"
+#include "k-way-merge.hpp"
+
+namespace bork_lib
+{
+
+struct ExternalSortConfig
+{
+    std::size_t memory_budget = std::size_t{256} << 20;   // bytes of records held in memory
+    std::size_t min_merge_buffer = std::size_t{1} << 18;  // smallest read buffer per run, in bytes
+};
+
+struct ExternalSortStats
+{
+    std::uint64_t bytes_read = 0;
+    std::uint64_t bytes_written = 0;
+    std::size_t runs = 0;
+    std::size_t merge_passes = 0;
+    double run_seconds = 0.0;     // reading, sorting and spilling the runs
+    double merge_seconds = 0.0;   // merging the runs into the output
+
+    /* Returns the combined read and write throughput in MB/s. */
+    double throughput() const
+    {
+        auto seconds = run_seconds + merge_seconds;
+        return seconds > 0.0 ? static_cast<double>(bytes_read + bytes_written) / seconds / 1e6 : 0.0;
+    }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, int(*)(std::FILE*)>;
+
+/* Opens a file, throwing if that fails. */
+inline FilePtr open_file(const std::string& path, const char* mode)
+{
+    FilePtr file{std::fopen(path.c_str(), mode), &std::fclose};
+    if (!file) {
+        throw std::runtime_error("Unable to open " + path + ".");
+    }
+    return file;
+}
+
+/* Creates an anonymous temporary file for a run, which is removed once it is closed. */
+inline FilePtr open_temp_file()
+{
+    FilePtr file{std::tmpfile(), &std::fclose};
+    if (!file) {
+        throw std::runtime_error("Unable to create a temporary file.");
+    }
+    return file;
+}
+
+/* Reads up to count records and returns the number read. */
+template<typename Record>
+std::size_t read_records(std::FILE* file, Record* records, std::size_t count)
+{
+    auto read = std::fread(records, sizeof(Record), count, file);
+    if (read < count && std::ferror(file)) {
+        throw std::runtime_error("Error reading records.");
+    }
+    return read;
+}
+
+/* Writes count records. */
+template<typename Record>
+void write_records(std::FILE* file, const Record* records, std::size_t count)
+{
+    if (std::fwrite(records, sizeof(Record), count, file) != count) {
+        throw std::runtime_error("Error writing records.");
+    }
+}
+
+/* Streams the records of a run through two buffers: while one is consumed, the next
+ * chunk of the file is read into the other in the background. */
+template<typename Record>
+class RunReader
+{
+private:
+    std::FILE* file;
+    std::vector<Record> buffers[2];
+    std::size_t sizes[2] = {0, 0};
+    std::size_t active = 0;
+    std::size_t pos = 0;
+    std::future<std::size_t> pending;
+    std::uint64_t bytes = 0;
+    void read_ahead();
+
+public:
+    RunReader(std::FILE* file, std::size_t buffer_records);
+    bool next(Record& record);
+    std::uint64_t bytes_read() const noexcept { return bytes; }
+};
+
+/* Private function that starts filling the inactive buffer. */
+template<typename Record>
+void RunReader<Record>::read_ahead()
+{
+    auto& buffer = buffers[1 - active];
+    pending = std::async(std::launch::async, [this, &buffer] {
+        return read_records(file, buffer.data(), buffer.size());
+    });
+}
+
+/* Constructor. Reads the first chunk and starts reading the second. */
+template<typename Record>
+RunReader<Record>::RunReader(std::FILE* file, std::size_t buffer_records) : file{file}
+{
+    buffers[0].resize(buffer_records);
+    buffers[1].resize(buffer_records);
+    sizes[0] = read_records(file, buffers[0].data(), buffer_records);
+    bytes += sizes[0] * sizeof(Record);
+    if (sizes[0] == buffer_records) {
+        read_ahead();
+    }
+}
+
+/* Retrieves the next record. Returns false once the run is exhausted. */
+template<typename Record>
+bool RunReader<Record>::next(Record& record)
+{
+    if (pos == sizes[active]) {
+        if (!pending.valid()) {
+            return false;
+        }
+
+        active = 1 - active;
+        sizes[active] = pending.get();
+        bytes += sizes[active] * sizeof(Record);
+        pos = 0;
+        if (sizes[active] == 0) {
+            return false;
+        }
+        if (sizes[active] == buffers[active].size()) {
+            read_ahead();
+        }
+    }
+
+    record = buffers[active][pos++];
+    return true;
+}
+
+/* Collects records in one buffer while the previous buffer is written in the background. */
+template<typename Record>
+class RunWriter
+{
+private:
+    std::FILE* file;
+    std::vector<Record> buffers[2];
+    std::size_t active = 0;
+    std::size_t fill = 0;
+    std::future<void> pending;
+    std::uint64_t bytes = 0;
+    void flush();
+
+public:
+    RunWriter(std::FILE* file, std::size_t buffer_records);
+    void push(const Record& record);
+    void finish();
+    std::uint64_t bytes_written() const noexcept { return bytes; }
+};
+
+/* Private function that hands the active buffer to a background write. */
+template<typename Record>
+void RunWriter<Record>::flush()
+{
+    if (pending.valid()) {
+        pending.get();
+    }
+
+    auto count = fill;
+    auto& buffer = buffers[active];
+    pending = std::async(std::launch::async, [this, &buffer, count] {
+        write_records(file, buffer.data(), count);
+    });
+    bytes += count * sizeof(Record);
+    active = 1 - active;
+    fill = 0;
+}
+
+/* Constructor. */
+template<typename Record>
+RunWriter<Record>::RunWriter(std::FILE* file, std::size_t buffer_records) : file{file}
+{
+    buffers[0].resize(buffer_records);
+    buffers[1].resize(buffer_records);
+}
+
+/* Appends a record. */
+template<typename Record>
+void RunWriter<Record>::push(const Record& record)
+{
+    buffers[active][fill++] = record;
+    if (fill == buffers[active].size()) {
+        flush();
+    }
+}
+
+/* Writes the remaining records and waits for all writes to complete. */
+template<typename Record>
+void RunWriter<Record>::finish()
+{
+    flush();
+    pending.get();
+    if (std::fflush(file) != 0) {
+        throw std::runtime_error("Error writing records.");
+    }
+}
+
+/* Private function that k-way merges the runs into the output with a loser tree. */
+template<typename Record>
+void merge_runs(std::vector<FilePtr>& runs, std::FILE* output, std::size_t buffer_records,
+                ExternalSortStats& stats)
+{
+    std::vector<std::unique_ptr<RunReader<Record>>> readers;
+    for (auto& run : runs) {
+        std::rewind(run.get());
+        readers.push_back(std::make_unique<RunReader<Record>>(run.get(), buffer_records));
+    }
+
+    RunWriter<Record> writer{output, buffer_records};
+    k_way_merge_streams<Record>(readers.size(),
+                                [&readers](std::size_t i, Record& record) { return readers[i]->next(record); },
+                                [&writer](const Record& record) { writer.push(record); });
+    writer.finish();
+
+    for (const auto& reader : readers) {
+        stats.bytes_read += reader->bytes_read();
+    }
+    stats.bytes_written += writer.bytes_written();
+}
+
+/* Sorts a binary file of fixed-size records that may be larger than memory. Chunks that
+ * fit in the memory budget are read with large buffered reads, sorted in memory with the
+ * given sort and spilled to temporary files as runs. The runs are then k-way merged with
+ * a loser tree and double-buffered I/O. If the budget cannot give every run a read buffer
+ * of min_merge_buffer bytes, groups of runs are merged into longer runs first. */
+template<typename Record>
+ExternalSortStats external_sort(const std::string& input_path, const std::string& output_path,
+                                const ExternalSortConfig& config = ExternalSortConfig{},
+                                const std::function<void(Record*, Record*)>& sort = introsort<Record*>)
+{
+    static_assert(std::is_trivially_copyable_v<Record>, "records must be trivially copyable");
+    ExternalSortStats stats;
+    auto run_records = std::max<std::size_t>(config.memory_budget / sizeof(Record), 1);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<FilePtr> runs;
+    {
+        auto input = open_file(input_path, "rb");
+        std::vector<Record> chunk(run_records);
+        while (auto count = read_records(input.get(), chunk.data(), run_records)) {
+            stats.bytes_read += count * sizeof(Record);
+            sort(chunk.data(), chunk.data() + count);
+            if (runs.empty() && count < run_records) {   // the whole input fits in memory
+                auto output = open_file(output_path, "wb");
+                write_records(output.get(), chunk.data(), count);
+                stats.bytes_written += count * sizeof(Record);
+                stats.runs = 1;
+                stats.run_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                return stats;
+            }
+
+            runs.push_back(open_temp_file());
+            write_records(runs.back().get(), chunk.data(), count);
+            stats.bytes_written += count * sizeof(Record);
+        }
+    }
+    stats.runs = runs.size();
+    auto merge_start = std::chrono::steady_clock::now();
+    stats.run_seconds = std::chrono::duration<double>(merge_start - start).count();
+
+    // every run and the output get two buffers
+    auto max_fan_in = std::max<std::size_t>(config.memory_budget / (2 * config.min_merge_buffer), 3) - 1;
+    while (runs.size() > max_fan_in) {
+        std::vector<FilePtr> merged;
+        auto buffer_records = std::max<std::size_t>(config.memory_budget / (2 * (max_fan_in + 1) * sizeof(Record)), 1);
+        for (std::size_t i = 0; i < runs.size(); i += max_fan_in) {
+            std::vector<FilePtr> group;
+            for (auto j = i; j < std::min(i + max_fan_in, runs.size()); ++j) {
+                group.push_back(std::move(runs[j]));
+            }
+            merged.push_back(open_temp_file());
+            merge_runs<Record>(group, merged.back().get(), buffer_records, stats);
+        }
+        runs = std::move(merged);
+        ++stats.merge_passes;
+    }
+
+    auto output = open_file(output_path, "wb");
+    auto buffer_records = std::max<std::size_t>(config.memory_budget / (2 * (runs.size() + 1) * sizeof(Record)), 1);
+    merge_runs<Record>(runs, output.get(), buffer_records, stats);
+    ++stats.merge_passes;
+    stats.merge_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - merge_start).count();
+    return stats;
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef FUNNELSORT_HPP
+#define FUNNELSORT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "merge-sort.hpp"
+#include "projection.hpp"
+
+namespace bork_lib
+{
+
+/* Lazy funnelsort (Brodal and Fagerberg), a cache-oblivious merge sort: the input is split
+ * into n^(1/3) segments of n^(2/3) elements, which are sorted recursively and merged by a
+ * funnel. The funnel is a binary tree of mergers connected by buffers whose sizes and
+ * memory layout follow the recursive van Emde Boas split of the tree, so that at every
+ * level of the memory hierarchy some subtree of the funnel fits in the cache together with
+ * its buffers. That bounds the memory transfers by O((n / B) log_{M/B}(n / B)) for every
+ * cache size M and line size B without knowing either. */
+
+constexpr std::ptrdiff_t funnelsort_cutoff = 1 << 10;
+constexpr double funnel_buffer_factor = 16.0;
+
+/* The k-funnel that merges k sorted segments, where k is a power of two. Node 1 is the root
+ * and the children of node v are 2v and 2v + 1; the nodes from k on are the segments.
+ * Every node other than the root owns the buffer on the edge to its parent, which is
+ * refilled only once it is empty, hence "lazy". */
+template<typename T, typename Compare>
+class Funnel
+{
+private:
+    struct Node
+    {
+        T* begin;
+        T* head;
+        T* tail;
+        std::size_t capacity;
+        bool exhausted;   // nothing more can come up from below
+    };
+
+    std::size_t k;
+    std::vector<Node> nodes;
+    std::vector<T> storage;
+    Compare comp;
+    void layout(std::size_t root, int height, std::vector<std::size_t>& offsets, std::size_t& size);
+    void refill(std::size_t v);
+    T* fill(std::size_t v, T* out, T* out_end);
+
+public:
+    Funnel(T* data, const std::vector<std::ptrdiff_t>& bounds, Compare comp);
+    void merge(T* out) { fill(1, out, nullptr); }
+};
+
+/* Private function that sizes the buffers strictly inside the subtree of the given height:
+ * the tree is cut at half its height, the buffers on the cut get room for (2^height)^(3/2)
+ * elements, and the top tree and the bottom trees are laid out recursively, in that order. */
+template<typename T, typename Compare>
+void Funnel<T, Compare>::layout(std::size_t root, int height, std::vector<std::size_t>& offsets, std::size_t& size)
+{
+    if (height <= 1) {
+        return;
+    }
+
+    auto top = height / 2;
+    layout(root, top, offsets, size);
+    auto capacity = static_cast<std::size_t>(funnel_buffer_factor * std::pow(2.0, 1.5 * height));
+    for (auto r = root << top; r < (root + 1) << top; ++r) {
+        nodes[r].capacity = capacity;
+        offsets[r] = size;
+        size += capacity;
+        layout(r, height - top, offsets, size);
+    }
+}
+
+/* Constructor. The segments [bounds[i], bounds[i + 1]) of data must be sorted. */
+template<typename T, typename Compare>
+Funnel<T, Compare>::Funnel(T* data, const std::vector<std::ptrdiff_t>& bounds, Compare comp)
+  : k{bounds.size() - 1}, nodes(2 * k), comp{std::move(comp)}
+{
+    auto height = 0;
+    while ((std::size_t{1} << height) < k) {
+        ++height;
+    }
+
+    std::vector<std::size_t> offsets(k);
+    std::size_t size = 0;
+    layout(1, height, offsets, size);
+    storage.resize(size);
+    for (std::size_t v = 2; v < k; ++v) {
+        auto begin = storage.data() + offsets[v];
+        nodes[v] = {begin, begin, begin, nodes[v].capacity, false};
+    }
+    for (std::size_t i = 0; i < k; ++i) {
+        nodes[k + i] = {data + bounds[i], data + bounds[i], data + bounds[i + 1], 0, true};
+    }
+}
+
+/* Private function that refills the empty buffer of a node from its children. */
+template<typename T, typename Compare>
+void Funnel<T, Compare>::refill(std::size_t v)
+{
+    auto& node = nodes[v];
+    node.head = node.begin;
+    node.tail = fill(v, node.begin, node.begin + node.capacity);
+    node.exhausted = node.tail != node.begin + node.capacity;
+}
+
+/* Private function that merges the buffers of the children of v into [out, out_end), or
+ * until both are used up when out_end is null, refilling them whenever they run empty.
+ * Returns the end of the output. Ties go to the left child, which keeps the merge stable. */
+template<typename T, typename Compare>
+T* Funnel<T, Compare>::fill(std::size_t v, T* out, T* out_end)
+{
+    auto& left = nodes[2 * v];
+    auto& right = nodes[2 * v + 1];
+    while (out != out_end) {
+        if (left.head == left.tail && !left.exhausted) {
+            refill(2 * v);
+        }
+        if (right.head == right.tail && !right.exhausted) {
+            refill(2 * v + 1);
+        }
+
+        auto left_empty = left.head == left.tail;
+        auto right_empty = right.head == right.tail;
+        if (left_empty && right_empty) {
+            break;
+        }
+        if (left_empty || right_empty) {
+            auto& source = left_empty ? right : left;
+            auto count = source.tail - source.head;
+            if (out_end) {
+                count = std::min(count, out_end - out);
+            }
+            out = std::move(source.head, source.head + count, out);
+            source.head += count;
+            continue;
+        }
+
+        while (out != out_end && left.head != left.tail && right.head != right.tail) {
+            if (comp(*right.head, *left.head)) {
+                *out++ = std::move(*right.head++);
+            } else {
+                *out++ = std::move(*left.head++);
+            }
+        }
+    }
+    return out;
+}
+
+/* Private function that sorts the n elements at data. When into_buffer is set the sorted
+ * result is left in the buffer instead, so that the segments are merged from one array
+ * into the other and nothing is copied back. */
+template<typename T, typename Compare>
+void funnelsort_util(T* data, T* buffer, std::ptrdiff_t n, bool into_buffer, Compare comp)
+{
+    if (n <= funnelsort_cutoff) {
+        buffered_merge_sort(data, data + n, buffer, comp);
+        if (into_buffer) {
+            std::move(data, data + n, buffer);
+        }
+        return;
+    }
+
+    std::ptrdiff_t k = 2;
+    while (k * k * k < n) {
+        k *= 2;
+    }
+    std::vector<std::ptrdiff_t> bounds;
+    for (std::ptrdiff_t i = 0; i <= k; ++i) {
+        bounds.push_back(n * i / k);
+    }
+
+    auto from = into_buffer ? data : buffer;
+    for (std::ptrdiff_t i = 0; i < k; ++i) {
+        funnelsort_util(data + bounds[i], buffer + bounds[i], bounds[i + 1] - bounds[i], !into_buffer, comp);
+    }
+    Funnel<T, Compare>{from, bounds, comp}.merge(into_buffer ? buffer : data);
+}
+
+/* Stable lazy funnelsort, ordered by comp applied to the projected elements. Needs no
+ * tuning for the cache sizes of the machine; the constants above only trade recursion
+ * overhead against buffer space. Works on a contiguous copy of the range and a scratch
+ * array of the same size. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+void funnelsort(RandAccIter low, RandAccIter high, Compare comp, Proj proj = Proj{})
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    auto n = static_cast<std::ptrdiff_t>(high - low);
+    if (n < 2) {
+        return;
+    }
+
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    std::vector<T> data(std::make_move_iterator(low), std::make_move_iterator(high));
+    std::vector<T> buffer(data.size());
+    funnelsort_util(data.data(), buffer.data(), n, false, less);
+    std::move(data.begin(), data.end(), low);
+}
+
+template<typename RandAccIter>
+void funnelsort(RandAccIter low, RandAccIter high)
+{
+    funnelsort(low, high, std::less<>{});
+}
+
+} // end namespace
+
+#endif
@@ -3,14 +3,17 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iterator>
+#include <utility>
 #include <vector>
+#include "projection.hpp"
 
 namespace bork_lib
 {
 
-template<typename BidirIter>
-void max_heapify(BidirIter begin, std::size_t heap_size, BidirIter index)
+template<typename BidirIter, typename Compare>
+void max_heapify(BidirIter begin, std::size_t heap_size, BidirIter index, Compare comp)
 {
     auto left = begin, right = begin, end = begin;
     auto largest = index;
@@ -19,44 +22,138 @@ void max_heapify(BidirIter begin, std::size_t heap_size, BidirIter index)
     std::advance(right, 2*dist + 2);
     std::advance(end, heap_size);
 
-    if (left < end && *left > *index) {
+    if (left < end && comp(*index, *left)) {
         largest = left;
     }
-    if (right < end && *right > *largest) {
+    if (right < end && comp(*largest, *right)) {
         largest = right;
     }
     if (largest != index) {
         std::iter_swap(index, largest);
-        max_heapify(begin, heap_size, largest);
+        max_heapify(begin, heap_size, largest, comp);
     }
 }
 
 template<typename BidirIter>
-void build_max_heap(BidirIter begin, BidirIter end)
+void max_heapify(BidirIter begin, std::size_t heap_size, BidirIter index)
+{
+    max_heapify(begin, heap_size, index, std::less<>{});
+}
+
+template<typename BidirIter, typename Compare = std::less<>>
+void build_max_heap(BidirIter begin, BidirIter end, Compare comp = Compare{})
 {
     auto heap_size = static_cast<std::size_t>(std::distance(begin, end));
     auto rit = begin;
     std::advance(rit, heap_size / 2);
     for (;; --rit) {
-        max_heapify(begin, heap_size, rit);
+        max_heapify(begin, heap_size, rit, comp);
         if (rit == begin) {
             break;
         }
     }
 }
 
-template<typename BidirIter>
-void heapsort(BidirIter begin, BidirIter end)
+/* Heapsort ordered by comp applied to the projected elements. */
+template<typename BidirIter, typename Compare, typename Proj = Identity>
+void heapsort(BidirIter begin, BidirIter end, Compare comp, Proj proj = Proj{})
 {
-    build_max_heap(begin, end);
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    build_max_heap(begin, end, less);
     auto heap_size = static_cast<std::size_t>(std::distance(begin, end));
     auto rit = end;
     --rit;
     for (; rit != begin; --rit) {
         std::iter_swap(begin, rit);
         --heap_size;
-        max_heapify(begin, heap_size, begin);
+        max_heapify(begin, heap_size, begin, less);
+    }
+}
+
+template<typename BidirIter>
+void heapsort(BidirIter begin, BidirIter end)
+{
+    heapsort(begin, end, std::less<>{});
+}
+
+/* Floyd's bottom-up sift-down for an Arity-ary max heap of heap_size elements. The hole at
+ * index is first moved down to a leaf along the largest children, which costs Arity - 1
+ * comparisons per level, and value is then bubbled back up from there. Since value usually
+ * belongs near the bottom, this roughly halves the comparisons of the classic sift-down. */
+template<std::size_t Arity, typename RandAccIter, typename T, typename Compare = std::less<>>
+void sift_down_bottom_up(RandAccIter begin, std::ptrdiff_t heap_size, std::ptrdiff_t index, T value,
+                         Compare comp = Compare{})
+{
+    constexpr auto arity = static_cast<std::ptrdiff_t>(Arity);
+    auto hole = index;
+    while (true) {
+        auto first_child = arity * hole + 1;
+        if (first_child >= heap_size) {
+            break;
+        }
+        auto last_child = std::min(first_child + arity, heap_size);
+        auto largest = first_child;
+        for (auto child = first_child + 1; child < last_child; ++child) {
+            if (comp(begin[largest], begin[child])) {
+                largest = child;
+            }
+        }
+        begin[hole] = std::move(begin[largest]);
+        hole = largest;
     }
+
+    while (hole > index) {
+        auto parent = (hole - 1) / arity;
+        if (!comp(begin[parent], value)) {
+            break;
+        }
+        begin[hole] = std::move(begin[parent]);
+        hole = parent;
+    }
+    begin[hole] = std::move(value);
+}
+
+/* Iterative heapsort on an Arity-ary heap, using the bottom-up sift-down and plain index
+ * arithmetic. The children of a node are adjacent, so with Arity 4 or 8 they are read
+ * from one or two cache lines and the tree is only half or a third as deep. */
+template<std::size_t Arity, typename RandAccIter, typename Compare, typename Proj = Identity>
+void dary_heapsort(RandAccIter begin, RandAccIter end, Compare comp, Proj proj = Proj{})
+{
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+    constexpr auto arity = static_cast<std::ptrdiff_t>(Arity);
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    auto heap_size = static_cast<std::ptrdiff_t>(end - begin);
+    if (heap_size < 2) {
+        return;
+    }
+
+    for (auto index = (heap_size - 2) / arity; index >= 0; --index) {
+        sift_down_bottom_up<Arity>(begin, heap_size, index, std::move(begin[index]), less);
+    }
+    for (auto last = heap_size - 1; last > 0; --last) {
+        auto value = std::move(begin[last]);
+        begin[last] = std::move(begin[0]);
+        sift_down_bottom_up<Arity>(begin, last, 0, std::move(value), less);
+    }
+}
+
+template<std::size_t Arity, typename RandAccIter>
+void dary_heapsort(RandAccIter begin, RandAccIter end)
+{
+    dary_heapsort<Arity>(begin, end, std::less<>{});
+}
+
+/* Iterative binary heapsort with the bottom-up sift-down. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+void bottom_up_heapsort(RandAccIter begin, RandAccIter end, Compare comp, Proj proj = Proj{})
+{
+    dary_heapsort<2>(begin, end, std::move(comp), std::move(proj));
+}
+
+template<typename RandAccIter>
+void bottom_up_heapsort(RandAccIter begin, RandAccIter end)
+{
+    dary_heapsort<2>(begin, end);
 }
 
 } // end namespace
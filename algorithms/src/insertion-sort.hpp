@@ -1,16 +1,20 @@
 #ifndef INSERTIONSORT_H
 #define INSERTIONSORT_H
 
+#include <functional>
 #include <iterator>
+#include <utility>
+#include "projection.hpp"
 
-template<typename InputIterator>
-void insertion_sort(InputIterator low, InputIterator high)
+template<typename InputIterator, typename Compare, typename Proj = bork_lib::Identity>
+void insertion_sort(InputIterator low, InputIterator high, Compare comp, Proj proj = Proj{})
 {
     using T = typename std::iterator_traits<InputIterator>::value_type;
+    auto less = bork_lib::make_projected_compare(std::move(comp), std::move(proj));
     for (auto i = low + 1; i != high; ++i) {
         T key = *i;
         auto j = i - 1;
-        for (; (j != low - 1) && (*j > key); --j) {
+        for (; (j != low - 1) && less(key, *j); --j) {
             *(j + 1) = *j;
         }
 
@@ -18,4 +22,10 @@ void insertion_sort(InputIterator low, InputIterator high)
     }
 }
 
+template<typename InputIterator>
+void insertion_sort(InputIterator low, InputIterator high)
+{
+    insertion_sort(low, high, std::less<>{});
+}
+
 #endif
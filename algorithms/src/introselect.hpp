@@ -0,0 +1,164 @@
+#ifndef INTROSELECT_HPP
+#define INTROSELECT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <utility>
+#include "insertion-sort.hpp"
+#include "introsort.hpp"
+#include "projection.hpp"
+
+namespace bork_lib
+{
+
+/* The selection routines rearrange the range like std::nth_element: *nth ends up holding
+ * the element that would be there if the range were sorted, [low, nth) holds no element
+ * greater than it and (nth, high) holds no element less than it. */
+
+constexpr std::ptrdiff_t median_group_size = 5;
+constexpr std::ptrdiff_t introselect_work_factor = 4;
+
+template<typename RandAccIter, typename Compare>
+void median_of_medians_select(RandAccIter low, RandAccIter nth, RandAccIter high, Compare comp);
+
+/* Returns a pivot whose rank lies between roughly 30% and 70% of the range: the median of
+ * the medians of groups of five (BFPRT). The group medians are gathered at the front of the
+ * range and their median is found with a recursive selection. */
+template<typename RandAccIter, typename Compare>
+RandAccIter median_of_medians(RandAccIter low, RandAccIter high, Compare comp)
+{
+    auto n = high - low;
+    auto medians = low;
+    for (std::ptrdiff_t i = 0; i < n; i += median_group_size) {
+        auto group = low + i;
+        auto group_size = std::min(median_group_size, n - i);
+        insertion_sort(group, group + group_size, comp);
+        std::iter_swap(medians, group + (group_size - 1) / 2);
+        ++medians;
+    }
+
+    auto mid = low + (medians - low - 1) / 2;
+    median_of_medians_select(low, mid, medians, comp);
+    return mid;
+}
+
+/* Private function that partitions the range into the pieces left and right of the
+ * pivot at *low and narrows it to the piece that holds nth. */
+template<typename RandAccIter, typename Compare>
+void narrow_to_nth(RandAccIter& low, RandAccIter nth, RandAccIter& high, Compare comp)
+{
+    auto p = bork_lib::partition(low, high, comp) + 1;
+    if (nth < p) {
+        high = p;
+    } else {
+        low = p;
+    }
+}
+
+/* Selection in worst-case linear time, using the median of medians as every pivot. */
+template<typename RandAccIter, typename Compare>
+void median_of_medians_select(RandAccIter low, RandAccIter nth, RandAccIter high, Compare comp)
+{
+    while (high - low > introsort_threshold) {
+        std::iter_swap(low, median_of_medians(low, high, comp));
+        narrow_to_nth(low, nth, high, comp);
+    }
+
+    if (high - low > 1) {
+        insertion_sort(low, high, comp);
+    }
+}
+
+/* Selection with the same pivots as introsort, ordered by comp applied to the projected
+ * elements. Runs in expected linear time, and once the partitions have touched more than
+ * four times the length of the range, the rest is finished with the median of medians,
+ * which keeps the worst case linear too. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+void introselect(RandAccIter low, RandAccIter nth, RandAccIter high, Compare comp, Proj proj = Proj{})
+{
+    if (nth == high) {
+        return;
+    }
+
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    auto work_left = introselect_work_factor * (high - low);
+    while (high - low > introsort_threshold) {
+        work_left -= high - low;
+        if (work_left < 0) {
+            median_of_medians_select(low, nth, high, less);
+            return;
+        }
+
+        choose_pivot(low, high, less);
+        narrow_to_nth(low, nth, high, less);
+    }
+
+    if (high - low > 1) {
+        insertion_sort(low, high, less);
+    }
+}
+
+template<typename RandAccIter>
+void introselect(RandAccIter low, RandAccIter nth, RandAccIter high)
+{
+    introselect(low, nth, high, std::less<>{});
+}
+
+/* Hoare's quickselect with pivots drawn from the caller's random engine, ordered by comp
+ * applied to the projected elements. Expected linear time, but no worst-case guarantee. */
+template<typename RandAccIter, typename URBG, typename Compare, typename Proj = Identity>
+void quickselect(RandAccIter low, RandAccIter nth, RandAccIter high, URBG& re, Compare comp, Proj proj = Proj{})
+{
+    if (nth == high) {
+        return;
+    }
+
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    while (high - low > 1) {
+        std::uniform_int_distribution<typename std::iterator_traits<RandAccIter>::difference_type> dist{0, high - low - 1};
+        std::iter_swap(low, low + dist(re));
+        narrow_to_nth(low, nth, high, less);
+    }
+}
+
+template<typename RandAccIter, typename URBG>
+void quickselect(RandAccIter low, RandAccIter nth, RandAccIter high, URBG& re)
+{
+    quickselect(low, nth, high, re, std::less<>{});
+}
+
+/* Quickselect with a random engine seeded once from std::random_device. */
+template<typename RandAccIter>
+void quickselect(RandAccIter low, RandAccIter nth, RandAccIter high)
+{
+    std::mt19937 re{std::random_device{}()};
+    quickselect(low, nth, high, re);
+}
+
+/* Sorts the smallest middle - low elements into [low, middle) and leaves the rest in
+ * [middle, high) in no particular order: introselect moves them in front of middle and
+ * introsort orders them, in O(n + k log k) time for k = middle - low. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+void partial_sort(RandAccIter low, RandAccIter middle, RandAccIter high, Compare comp, Proj proj = Proj{})
+{
+    if (middle == low) {
+        return;
+    }
+
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    introselect(low, middle - 1, high, less);
+    introsort(low, middle - 1, less);
+}
+
+template<typename RandAccIter>
+void partial_sort(RandAccIter low, RandAccIter middle, RandAccIter high)
+{
+    bork_lib::partial_sort(low, middle, high, std::less<>{});
+}
+
+} // end namespace
+
+#endif
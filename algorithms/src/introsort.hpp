@@ -0,0 +1,115 @@
+#ifndef INTROSORT_HPP
+#define INTROSORT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "heapsort.hpp"
+#include "insertion-sort.hpp"
+#include "projection.hpp"
+#include "quicksort-hoare.hpp"
+
+namespace bork_lib
+{
+
+constexpr std::ptrdiff_t introsort_threshold = 16;
+constexpr std::ptrdiff_t ninther_threshold = 128;
+
+/* Returns the iterator that refers to the median of the three elements. */
+template<typename RandAccIter, typename Compare = std::less<>>
+RandAccIter median_of_three(RandAccIter a, RandAccIter b, RandAccIter c, Compare comp = Compare{})
+{
+    if (comp(*a, *b)) {
+        if (comp(*b, *c)) {
+            return b;
+        }
+        return comp(*a, *c) ? c : a;
+    }
+    if (comp(*a, *c)) {
+        return a;
+    }
+    return comp(*b, *c) ? c : b;
+}
+
+/* Moves a pivot to the front of the range: the median of three for short ranges and
+ * Tukey's ninther (the median of three medians of three) for long ones. */
+template<typename RandAccIter, typename Compare = std::less<>>
+void choose_pivot(RandAccIter low, RandAccIter high, Compare comp = Compare{})
+{
+    auto n = high - low;
+    auto mid = low + n / 2;
+    auto last = high - 1;
+    RandAccIter pivot;
+    if (n > ninther_threshold) {
+        auto step = n / 8;
+        pivot = median_of_three(median_of_three(low, low + step, low + 2 * step, comp),
+                                median_of_three(mid - step, mid, mid + step, comp),
+                                median_of_three(last - 2 * step, last - step, last, comp), comp);
+    } else {
+        pivot = median_of_three(low, mid, last, comp);
+    }
+    std::iter_swap(low, pivot);
+}
+
+/* Returns floor(log2(n)) for n > 0. */
+inline int floor_log2(std::ptrdiff_t n)
+{
+    int log = 0;
+    for (; n > 1; n >>= 1) {
+        ++log;
+    }
+    return log;
+}
+
+/* Private function that quicksorts until the depth limit is exhausted, then hands the
+ * partition to heapsort. Partitions at or below the threshold are left for insertion sort.
+ * Recurses on the smaller side and loops on the larger one to bound the stack depth. */
+template<typename RandAccIter, typename Compare>
+void introsort_loop(RandAccIter low, RandAccIter high, int depth_limit, Compare comp)
+{
+    while (high - low > introsort_threshold) {
+        if (depth_limit == 0) {
+            bottom_up_heapsort(low, high, comp);
+            return;
+        }
+        --depth_limit;
+
+        choose_pivot(low, high, comp);
+        auto p = bork_lib::partition(low, high, comp) + 1;   // qualified to keep std::partition out of ADL
+        if (p - low < high - p) {
+            introsort_loop(low, p, depth_limit, comp);
+            low = p;
+        } else {
+            introsort_loop(p, high, depth_limit, comp);
+            high = p;
+        }
+    }
+
+    if (high - low > 1) {
+        insertion_sort(low, high, comp);
+    }
+}
+
+/* Sorts the range in guaranteed O(n log n) time, ordered by comp applied to the projected
+ * elements. */
+template<typename RandAccIter, typename Compare, typename Proj = Identity>
+void introsort(RandAccIter low, RandAccIter high, Compare comp, Proj proj = Proj{})
+{
+    if (high - low < 2) {
+        return;
+    }
+
+    introsort_loop(low, high, 2 * floor_log2(high - low), make_projected_compare(std::move(comp), std::move(proj)));
+}
+
+/* Sorts the range in guaranteed O(n log n) time. */
+template<typename RandAccIter>
+void introsort(RandAccIter low, RandAccIter high)
+{
+    introsort(low, high, std::less<>{});
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef K_WAY_MERGE_HPP
+#define K_WAY_MERGE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "projection.hpp"
+#include "../../data-structures/src/LoserTree.hpp"
+
+namespace bork_lib
+{
+
+/* k-way merging with a loser tree: every output element costs log(k) comparisons and is
+ * copied once, however many runs there are, instead of passing through log(k) rounds of
+ * pairwise merges. Merges are stable, ties going to the run that comes first. */
+
+/* Compares two iterators by the elements they point to. */
+template<typename Compare>
+struct DereferenceCompare
+{
+    Compare comp;
+
+    template<typename Iter>
+    bool operator()(const Iter& a, const Iter& b) const { return comp(*a, *b); }
+};
+
+/* Merges the sorted runs, given as [first, last) pairs, into the output and returns the
+ * end of the output, ordered by comp applied to the projected elements. The tree holds
+ * iterators, so elements are only touched to compare them and to write them out; pass
+ * std::move_iterator runs to move the elements instead of copying them. */
+template<typename InputIter, typename OutputIter, typename Compare, typename Proj = Identity>
+OutputIter k_way_merge(const std::vector<std::pair<InputIter, InputIter>>& runs, OutputIter out, Compare comp,
+                       Proj proj = Proj{})
+{
+    using Less = decltype(make_projected_compare(std::move(comp), std::move(proj)));
+    LoserTree<InputIter, DereferenceCompare<Less>> tree{runs.size(),
+        DereferenceCompare<Less>{make_projected_compare(std::move(comp), std::move(proj))}};
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        if (runs[i].first != runs[i].second) {
+            tree.set(i, runs[i].first);
+        }
+    }
+    tree.build();
+
+    while (!tree.empty()) {
+        auto it = tree.top();
+        *out = *it;
+        ++out;
+        if (++it != runs[tree.top_source()].second) {
+            tree.replace_top(it);
+        } else {
+            tree.pop_top();
+        }
+    }
+    return out;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter k_way_merge(const std::vector<std::pair<InputIter, InputIter>>& runs, OutputIter out)
+{
+    return k_way_merge(runs, out, std::less<>{});
+}
+
+/* Merges k sorted streams that can only be read one value at a time, such as runs on
+ * disk. next(i, value) stores the next value of stream i and returns false once the stream
+ * is exhausted; sink(value) receives the merged values in order. */
+template<typename T, typename Next, typename Sink, typename Compare = std::less<>>
+void k_way_merge_streams(std::size_t k, Next next, Sink sink, Compare comp = Compare{})
+{
+    LoserTree<T, Compare> tree{k, std::move(comp)};
+    T value;
+    for (std::size_t i = 0; i < k; ++i) {
+        if (next(i, value)) {
+            tree.set(i, std::move(value));
+        }
+    }
+    tree.build();
+
+    while (!tree.empty()) {
+        sink(tree.top());
+        if (next(tree.top_source(), value)) {
+            tree.replace_top(std::move(value));
+        } else {
+            tree.pop_top();
+        }
+    }
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef LEAF_SORT_HPP
+#define LEAF_SORT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace bork_lib
+{
+
+/* Leaf sorters are the policies the recursive sorts hand their small ranges to. Each one
+ * provides the largest range it accepts (max_size) and a static sort function that takes
+ * an optional comparator. */
+
+/* Stable insertion sort that moves elements instead of copying them. */
+template<typename RandAccIter, typename Compare = std::less<>>
+void insertion_sort_move(RandAccIter low, RandAccIter high, Compare comp = Compare{})
+{
+    if (high - low < 2) {
+        return;
+    }
+
+    for (auto i = low + 1; i != high; ++i) {
+        auto key = std::move(*i);
+        auto j = i;
+        for (; j != low && comp(key, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(key);
+    }
+}
+
+/* Recurses all the way down to single elements. */
+struct NoLeafSort
+{
+    static constexpr std::ptrdiff_t max_size = 1;
+    template<typename RandAccIter, typename Compare = std::less<>>
+    static void sort(RandAccIter, RandAccIter, Compare = Compare{}) {}
+};
+
+/* Finishes short ranges with a stable insertion sort. */
+struct InsertionLeafSort
+{
+    static constexpr std::ptrdiff_t max_size = 16;
+    template<typename RandAccIter, typename Compare = std::less<>>
+    static void sort(RandAccIter low, RandAccIter high, Compare comp = Compare{}) { insertion_sort_move(low, high, comp); }
+};
+
+} // end namespace
+
+#endif
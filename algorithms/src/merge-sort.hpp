@@ -1,14 +1,20 @@
 #ifndef MERGESORT_HPP
 #define MERGESORT_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iterator>
 #include <utility>
 #include <vector>
+#include "k-way-merge.hpp"
+#include "leaf-sort.hpp"
+#include "projection.hpp"
 
 namespace bork_lib
 {
-    template<typename ForwardIter>
-    void merge(ForwardIter low, ForwardIter mid, ForwardIter high)
+    template<typename ForwardIter, typename Compare = std::less<>>
+    void merge(ForwardIter low, ForwardIter mid, ForwardIter high, Compare comp = Compare{})
     {
         using T = typename std::iterator_traits<ForwardIter>::value_type;
         std::vector<T> left{low, mid};
@@ -18,7 +24,7 @@ namespace bork_lib
 
         auto output_iter = low;
         for (; left_iter != left.end() && right_iter != right.end(); ++output_iter) {
-            if (*left_iter <= *right_iter) {
+            if (!comp(*right_iter, *left_iter)) {
                 *output_iter = *left_iter;
                 ++left_iter;
             } else {
@@ -31,18 +37,199 @@ namespace bork_lib
         std::move(right_iter, right.end(), output_iter);
     }
 
-    template<typename ForwardIter>
-    void merge_sort(ForwardIter low, ForwardIter high)
+    /* Stable merge sort ordered by comp applied to the projected elements. */
+    template<typename ForwardIter, typename Compare, typename Proj = Identity>
+    void merge_sort(ForwardIter low, ForwardIter high, Compare comp, Proj proj = Proj{})
     {
         auto dist = std::distance(low, high);
-        if (dist == typename ForwardIter::difference_type{1}) {
+        if (dist < typename ForwardIter::difference_type{2}) {
             return;
         }
 
+        auto less = make_projected_compare(std::move(comp), std::move(proj));
         auto mid = std::next(low, dist / 2);
-        merge_sort(low, mid);
-        merge_sort(mid, high);
-        merge(low, mid, high);
+        merge_sort(low, mid, less);
+        merge_sort(mid, high, less);
+        merge(low, mid, high, less);
+    }
+
+    template<typename ForwardIter>
+    void merge_sort(ForwardIter low, ForwardIter high)
+    {
+        merge_sort(low, high, std::less<>{});
+    }
+
+    /* Moves two sorted runs into the output, preferring the left run on ties. */
+    template<typename InIter, typename OutIter, typename Compare = std::less<>>
+    OutIter merge_move(InIter left, InIter left_end, InIter right, InIter right_end, OutIter out,
+                       Compare comp = Compare{})
+    {
+        for (; left != left_end && right != right_end; ++out) {
+            if (comp(*right, *left)) {
+                *out = std::move(*right);
+                ++right;
+            } else {
+                *out = std::move(*left);
+                ++left;
+            }
+        }
+
+        out = std::move(left, left_end, out);
+        return std::move(right, right_end, out);
+    }
+
+    /* Private function that sorts the n elements at data. When into_buffer is set the
+     * sorted result is left in the buffer instead, so that every level merges from one
+     * array into the other and nothing is copied back. */
+    template<typename LeafSort, typename DataIter, typename BufferIter, typename Compare = std::less<>>
+    void ping_pong_merge_sort(DataIter data, BufferIter buffer, std::ptrdiff_t n, bool into_buffer,
+                              Compare comp = Compare{})
+    {
+        if (n <= LeafSort::max_size) {
+            LeafSort::sort(data, data + n, comp);
+            if (into_buffer) {
+                std::move(data, data + n, buffer);
+            }
+            return;
+        }
+
+        auto half = n / 2;
+        ping_pong_merge_sort<LeafSort>(data, buffer, half, !into_buffer, comp);
+        ping_pong_merge_sort<LeafSort>(data + half, buffer + half, n - half, !into_buffer, comp);
+        if (into_buffer) {
+            merge_move(data, data + half, data + half, data + n, buffer, comp);
+        } else {
+            merge_move(buffer, buffer + half, buffer + half, buffer + n, data, comp);
+        }
+    }
+
+    /* Stable merge sort that uses the caller's scratch buffer, which must hold at least
+     * high - low elements, and performs no allocation. Takes an optional comparator and
+     * projection. */
+    template<typename RandAccIter, typename BufferIter, typename LeafSort = InsertionLeafSort,
+             typename Compare = std::less<>, typename Proj = Identity>
+    void buffered_merge_sort(RandAccIter low, RandAccIter high, BufferIter buffer,
+                             Compare comp = Compare{}, Proj proj = Proj{})
+    {
+        auto n = static_cast<std::ptrdiff_t>(high - low);
+        if (n < 2) {
+            return;
+        }
+
+        ping_pong_merge_sort<LeafSort>(low, buffer, n, false, make_projected_compare(std::move(comp), std::move(proj)));
+    }
+
+    /* Stable merge sort that allocates a single scratch buffer for the whole sort. */
+    template<typename RandAccIter, typename LeafSort = InsertionLeafSort>
+    void buffered_merge_sort(RandAccIter low, RandAccIter high)
+    {
+        using T = typename std::iterator_traits<RandAccIter>::value_type;
+        if (high - low < 2) {
+            return;
+        }
+
+        // the elements now live in the buffer, so sort them back into the range
+        std::vector<T> buffer(std::make_move_iterator(low), std::make_move_iterator(high));
+        ping_pong_merge_sort<LeafSort>(buffer.begin(), low, static_cast<std::ptrdiff_t>(buffer.size()), true);
+    }
+
+    /* Iterative merge sort: leaf-sorts short runs in place, then merges runs of doubling
+     * width back and forth between the range and the caller's scratch buffer. Takes an
+     * optional comparator and projection. */
+    template<typename RandAccIter, typename BufferIter, typename LeafSort = InsertionLeafSort,
+             typename Compare = std::less<>, typename Proj = Identity>
+    void bottom_up_merge_sort(RandAccIter low, RandAccIter high, BufferIter buffer,
+                              Compare comp = Compare{}, Proj proj = Proj{})
+    {
+        auto less = make_projected_compare(std::move(comp), std::move(proj));
+        auto n = static_cast<std::ptrdiff_t>(high - low);
+        for (std::ptrdiff_t i = 0; i < n; i += LeafSort::max_size) {
+            LeafSort::sort(low + i, low + std::min(i + LeafSort::max_size, n), less);
+        }
+
+        bool in_buffer = false;
+        for (auto width = LeafSort::max_size; width < n; width *= 2) {
+            for (std::ptrdiff_t i = 0; i < n; i += 2 * width) {
+                auto mid = std::min(i + width, n);
+                auto end = std::min(i + 2 * width, n);
+                if (in_buffer) {
+                    merge_move(buffer + i, buffer + mid, buffer + mid, buffer + end, low + i, less);
+                } else {
+                    merge_move(low + i, low + mid, low + mid, low + end, buffer + i, less);
+                }
+            }
+            in_buffer = !in_buffer;
+        }
+
+        if (in_buffer) {
+            std::move(buffer, buffer + n, low);
+        }
+    }
+
+    /* Iterative merge sort that allocates a single scratch buffer for the whole sort. */
+    template<typename RandAccIter, typename LeafSort = InsertionLeafSort>
+    void bottom_up_merge_sort(RandAccIter low, RandAccIter high)
+    {
+        using T = typename std::iterator_traits<RandAccIter>::value_type;
+        std::vector<T> buffer(static_cast<std::size_t>(high - low));
+        bottom_up_merge_sort<RandAccIter, typename std::vector<T>::iterator, LeafSort>(low, high, buffer.begin());
+    }
+
+    constexpr std::ptrdiff_t multiway_merge_fan_in = 8;
+
+    /* Private function that merges every group of fan_in adjacent runs of the given width
+     * from one array into the other. */
+    template<typename InIter, typename OutIter, typename Compare>
+    void multiway_merge_pass(InIter from, OutIter to, std::ptrdiff_t n, std::ptrdiff_t width, Compare comp)
+    {
+        std::vector<std::pair<std::move_iterator<InIter>, std::move_iterator<InIter>>> runs;
+        for (std::ptrdiff_t i = 0; i < n; i += multiway_merge_fan_in * width) {
+            runs.clear();
+            for (auto j = i; j < std::min(i + multiway_merge_fan_in * width, n); j += width) {
+                runs.emplace_back(std::make_move_iterator(from + j), std::make_move_iterator(from + std::min(j + width, n)));
+            }
+            k_way_merge(runs, to + i, comp);
+        }
+    }
+
+    /* Iterative merge sort that merges eight runs at a time with a loser tree instead of
+     * two, so every element is moved log_8 rather than log_2 times for the same number of
+     * comparisons. That pays off for wide elements, where moves cost more than comparisons;
+     * for small keys bottom_up_merge_sort is faster. Uses the caller's scratch buffer and
+     * takes an optional comparator and projection. */
+    template<typename RandAccIter, typename BufferIter, typename LeafSort = InsertionLeafSort,
+             typename Compare = std::less<>, typename Proj = Identity>
+    void multiway_merge_sort(RandAccIter low, RandAccIter high, BufferIter buffer,
+                             Compare comp = Compare{}, Proj proj = Proj{})
+    {
+        auto less = make_projected_compare(std::move(comp), std::move(proj));
+        auto n = static_cast<std::ptrdiff_t>(high - low);
+        for (std::ptrdiff_t i = 0; i < n; i += LeafSort::max_size) {
+            LeafSort::sort(low + i, low + std::min(i + LeafSort::max_size, n), less);
+        }
+
+        bool in_buffer = false;
+        for (auto width = LeafSort::max_size; width < n; width *= multiway_merge_fan_in) {
+            if (in_buffer) {
+                multiway_merge_pass(buffer, low, n, width, less);
+            } else {
+                multiway_merge_pass(low, buffer, n, width, less);
+            }
+            in_buffer = !in_buffer;
+        }
+
+        if (in_buffer) {
+            std::move(buffer, buffer + n, low);
+        }
+    }
+
+    /* Multiway merge sort that allocates a single scratch buffer for the whole sort. */
+    template<typename RandAccIter, typename LeafSort = InsertionLeafSort>
+    void multiway_merge_sort(RandAccIter low, RandAccIter high)
+    {
+        using T = typename std::iterator_traits<RandAccIter>::value_type;
+        std::vector<T> buffer(static_cast<std::size_t>(high - low));
+        multiway_merge_sort<RandAccIter, typename std::vector<T>::iterator, LeafSort>(low, high, buffer.begin());
     }
 }
 
@@ -0,0 +1,131 @@
+#ifndef PARALLEL_MERGESORT_HPP
+#define PARALLEL_MERGESORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "merge-sort.hpp"
+#include "thread-pool.hpp"
+
+namespace bork_lib
+{
+
+constexpr std::ptrdiff_t parallel_sort_cutoff = 1 << 14;
+constexpr std::ptrdiff_t parallel_merge_cutoff = 1 << 15;
+
+/* Returns how many elements of the left run precede position k of the merged output. Ties
+ * are resolved in favor of the left run, which keeps the parallel merge stable. */
+template<typename RandAccIter>
+std::ptrdiff_t co_rank(std::ptrdiff_t k, RandAccIter left, std::ptrdiff_t left_size,
+                       RandAccIter right, std::ptrdiff_t right_size)
+{
+    auto lo = std::max<std::ptrdiff_t>(0, k - right_size);
+    auto hi = std::min(k, left_size);
+    while (lo < hi) {
+        auto i = lo + (hi - lo) / 2;
+        auto j = k - i;
+        if (j > 0 && !(right[j - 1] < left[i])) {   // left[i] belongs before right[j - 1]
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+
+    return lo;
+}
+
+/* Merges two sorted runs into the output, splitting the output into equal pieces with
+ * co_rank and merging the pieces in parallel. */
+template<typename InIter, typename OutIter>
+void parallel_merge(InIter left, InIter left_end, InIter right, InIter right_end, OutIter out,
+                    ThreadPool& pool)
+{
+    auto left_size = left_end - left;
+    auto right_size = right_end - right;
+    auto total = left_size + right_size;
+    if (total <= parallel_merge_cutoff) {
+        merge_move(left, left_end, right, right_end, out);
+        return;
+    }
+
+    // every split is found before any task starts moving elements out of the runs
+    auto pieces = std::min(static_cast<std::ptrdiff_t>(pool.size()), total / parallel_merge_cutoff + 1);
+    std::vector<std::ptrdiff_t> splits(static_cast<std::size_t>(pieces + 1));
+    for (std::ptrdiff_t p = 0; p <= pieces; ++p) {
+        splits[static_cast<std::size_t>(p)] = co_rank(total * p / pieces, left, left_size, right, right_size);
+    }
+
+    TaskGroup group{pool};
+    for (std::ptrdiff_t p = 0; p < pieces; ++p) {
+        auto k_begin = total * p / pieces;
+        auto k_end = total * (p + 1) / pieces;
+        auto i_begin = splits[static_cast<std::size_t>(p)];
+        auto i_end = splits[static_cast<std::size_t>(p + 1)];
+        group.run([=] {
+            merge_move(left + i_begin, left + i_end, right + (k_begin - i_begin),
+                       right + (k_end - i_end), out + k_begin);
+        });
+    }
+    group.wait();
+}
+
+/* Private function that sorts the range starting at data. When into_buffer is set the
+ * sorted result is left in the buffer instead, so that every level merges from one array
+ * into the other without copying back. */
+template<typename RandAccIter, typename BufferIter>
+void parallel_merge_sort_util(RandAccIter data, BufferIter buffer, std::ptrdiff_t n,
+                              bool into_buffer, ThreadPool& pool, std::ptrdiff_t cutoff)
+{
+    if (n <= cutoff) {
+        buffered_merge_sort(data, data + n, buffer);
+        if (into_buffer) {
+            std::move(data, data + n, buffer);
+        }
+        return;
+    }
+
+    auto half = n / 2;
+    {
+        TaskGroup group{pool};
+        group.run([=, &pool] {
+            parallel_merge_sort_util(data, buffer, half, !into_buffer, pool, cutoff);
+        });
+        parallel_merge_sort_util(data + half, buffer + half, n - half, !into_buffer, pool, cutoff);
+        group.wait();
+    }
+
+    if (into_buffer) {
+        parallel_merge(data, data + half, data + half, data + n, buffer, pool);
+    } else {
+        parallel_merge(buffer, buffer + half, buffer + half, buffer + n, data, pool);
+    }
+}
+
+/* Sorts the range on the given pool. Produces exactly the same (stable) order as merge_sort. */
+template<typename RandAccIter>
+void parallel_merge_sort(RandAccIter low, RandAccIter high, ThreadPool& pool,
+                         std::ptrdiff_t cutoff = parallel_sort_cutoff)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    auto n = static_cast<std::ptrdiff_t>(high - low);
+    if (n < 2) {
+        return;
+    }
+
+    cutoff = std::max<std::ptrdiff_t>(cutoff, 1);
+    std::vector<T> buffer(static_cast<std::size_t>(n));
+    parallel_merge_sort_util(low, buffer.begin(), n, false, pool, cutoff);
+}
+
+/* Sorts the range on the shared pool. */
+template<typename RandAccIter>
+void parallel_merge_sort(RandAccIter low, RandAccIter high)
+{
+    parallel_merge_sort(low, high, ThreadPool::shared());
+}
+
+} // end namespace
+
+#endif
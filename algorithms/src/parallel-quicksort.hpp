@@ -0,0 +1,169 @@
+#ifndef PARALLEL_QUICKSORT_HPP
+#define PARALLEL_QUICKSORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "introsort.hpp"
+#include "thread-pool.hpp"
+
+namespace bork_lib
+{
+
+constexpr std::ptrdiff_t parallel_quicksort_cutoff = 1 << 14;
+constexpr std::ptrdiff_t parallel_partition_cutoff = 1 << 20;
+constexpr std::ptrdiff_t parallel_partition_block = 1 << 18;
+
+/* Partitions the range in place so that the elements satisfying pred come first, and
+ * returns the boundary. The range is cut into one block per worker and every block is
+ * partitioned concurrently. Afterwards the elements that ended up on the wrong side of the
+ * global boundary form two equally long lists of intervals, and the workers swap them
+ * pairwise, so the only extra memory is O(workers). */
+template<typename RandAccIter, typename Predicate>
+RandAccIter parallel_partition(RandAccIter low, RandAccIter high, Predicate pred, ThreadPool& pool)
+{
+    using Interval = std::pair<std::ptrdiff_t, std::ptrdiff_t>;
+    auto n = high - low;
+    auto blocks = std::min(static_cast<std::ptrdiff_t>(pool.size()), n / parallel_partition_block);
+    if (blocks < 2) {
+        return std::partition(low, high, pred);
+    }
+
+    std::vector<std::ptrdiff_t> bounds(static_cast<std::size_t>(blocks + 1));
+    std::vector<std::ptrdiff_t> left_sizes(static_cast<std::size_t>(blocks));
+    for (std::ptrdiff_t b = 0; b <= blocks; ++b) {
+        bounds[static_cast<std::size_t>(b)] = n * b / blocks;
+    }
+    {
+        TaskGroup group{pool};
+        for (std::size_t b = 0; b < left_sizes.size(); ++b) {
+            group.run([=, &bounds, &left_sizes] {
+                auto mid = std::partition(low + bounds[b], low + bounds[b + 1], pred);
+                left_sizes[b] = mid - (low + bounds[b]);
+            });
+        }
+        group.wait();
+    }
+
+    std::ptrdiff_t split = 0;
+    for (auto size : left_sizes) {
+        split += size;
+    }
+
+    // misplaced elements: the right part of a block left of split, the left part right of it.
+    // Only non-empty intervals are kept, since the swap loop steps over one interval at a time.
+    std::vector<Interval> wrong_left, wrong_right;
+    for (std::size_t b = 0; b < left_sizes.size(); ++b) {
+        auto mid = bounds[b] + left_sizes[b];
+        if (mid < std::min(bounds[b + 1], split)) {
+            wrong_left.emplace_back(mid, std::min(bounds[b + 1], split));
+        }
+        if (std::max(bounds[b], split) < mid) {
+            wrong_right.emplace_back(std::max(bounds[b], split), mid);
+        }
+    }
+
+    auto prefix_sums = [](const std::vector<Interval>& intervals) {
+        std::vector<std::ptrdiff_t> sums{0};
+        for (const auto& interval : intervals) {
+            sums.push_back(sums.back() + interval.second - interval.first);
+        }
+        return sums;
+    };
+    auto left_sums = prefix_sums(wrong_left);
+    auto right_sums = prefix_sums(wrong_right);
+    auto misplaced = left_sums.back();
+    if (misplaced == 0) {
+        return low + split;
+    }
+
+    // maps the k-th misplaced element to its index in the range
+    auto locate = [](const std::vector<Interval>& intervals, const std::vector<std::ptrdiff_t>& sums,
+                     std::ptrdiff_t k) {
+        auto i = static_cast<std::size_t>(std::upper_bound(sums.begin(), sums.end(), k) - sums.begin() - 1);
+        return std::make_pair(i, intervals[i].first + (k - sums[i]));
+    };
+
+    TaskGroup group{pool};
+    for (std::ptrdiff_t b = 0; b < blocks; ++b) {
+        auto k_begin = misplaced * b / blocks;
+        auto k_end = misplaced * (b + 1) / blocks;
+        group.run([=, &wrong_left, &wrong_right, &left_sums, &right_sums] {
+            if (k_begin == k_end) {
+                return;
+            }
+            auto left = locate(wrong_left, left_sums, k_begin);
+            auto right = locate(wrong_right, right_sums, k_begin);
+            for (auto k = k_begin; k < k_end; ++k) {
+                if (left.second == wrong_left[left.first].second) {
+                    left.second = wrong_left[++left.first].first;
+                }
+                if (right.second == wrong_right[right.first].second) {
+                    right.second = wrong_right[++right.first].first;
+                }
+                std::iter_swap(low + left.second++, low + right.second++);
+            }
+        });
+    }
+    group.wait();
+
+    return low + split;
+}
+
+/* Private function that partitions around a ninther pivot, in parallel for large ranges,
+ * and sorts the two sides as independent tasks. Small ranges and ranges past the depth
+ * limit go to the sequential introsort. */
+template<typename RandAccIter>
+void parallel_quicksort_util(RandAccIter low, RandAccIter high, ThreadPool& pool, int depth_limit)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    while (high - low > parallel_quicksort_cutoff && depth_limit > 0) {
+        --depth_limit;
+        choose_pivot(low, high);
+        T pivot = *low;
+        auto partition_by = [&](auto pred) {
+            return high - low > parallel_partition_cutoff ? parallel_partition(low, high, pred, pool)
+                                                          : std::partition(low, high, pred);
+        };
+
+        auto mid = partition_by([&pivot](const T& x) { return x < pivot; });
+        if (mid == low) {
+            // the pivot is the minimum, so split off every element equal to it instead
+            mid = partition_by([&pivot](const T& x) { return !(pivot < x); });
+            low = mid;
+            continue;
+        }
+
+        TaskGroup group{pool};
+        group.run([=, &pool] { parallel_quicksort_util(low, mid, pool, depth_limit); });
+        parallel_quicksort_util(mid, high, pool, depth_limit);
+        group.wait();
+        return;
+    }
+
+    introsort(low, high);
+}
+
+/* Sorts the range in place on the given pool, using no O(n) extra memory. */
+template<typename RandAccIter>
+void parallel_quicksort(RandAccIter low, RandAccIter high, ThreadPool& pool)
+{
+    if (high - low < 2) {
+        return;
+    }
+
+    parallel_quicksort_util(low, high, pool, 2 * floor_log2(high - low));
+}
+
+/* Sorts the range in place on the shared pool. */
+template<typename RandAccIter>
+void parallel_quicksort(RandAccIter low, RandAccIter high)
+{
+    parallel_quicksort(low, high, ThreadPool::shared());
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef PROJECTION_HPP
+#define PROJECTION_HPP
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace bork_lib
+{
+
+/* The sort templates accept a comparator and a projection. The projection maps an element
+ * to the key that the comparator sees, so records can be sorted by a field without a
+ * wrapper type: sort(low, high, std::less<>{}, &Record::id). */
+
+/* Projection that returns its argument unchanged. */
+struct Identity
+{
+    template<typename T>
+    constexpr T&& operator()(T&& value) const noexcept { return std::forward<T>(value); }
+};
+
+/* Compares two elements by comparing their projections. */
+template<typename Compare, typename Proj>
+class ProjectedCompare
+{
+private:
+    Compare comp;
+    Proj proj;
+
+public:
+    ProjectedCompare(Compare comp, Proj proj) : comp{std::move(comp)}, proj{std::move(proj)} {}
+
+    template<typename T, typename U>
+    bool operator()(T&& a, U&& b) const
+    {
+        return std::invoke(comp, std::invoke(proj, std::forward<T>(a)), std::invoke(proj, std::forward<U>(b)));
+    }
+};
+
+/* Folds a projection into a comparator. The identity projection returns the comparator
+ * itself, so the plain overloads pay nothing for the indirection. */
+template<typename Compare, typename Proj>
+auto make_projected_compare(Compare comp, Proj proj)
+{
+    if constexpr (std::is_same_v<Proj, Identity>) {
+        return comp;
+    } else {
+        return ProjectedCompare<Compare, Proj>{std::move(comp), std::move(proj)};
+    }
+}
+
+} // end namespace
+
+#endif
@@ -1,24 +1,30 @@
 #ifndef QUICKSORT_HOARE_HPP
 #define QUICKSORT_HOARE_HPP
 
+#include <functional>
 #include <iterator>
+#include <utility>
+#include "block-partition.hpp"
+#include "leaf-sort.hpp"
+#include "projection.hpp"
+#include "three-way-partition.hpp"
 
 namespace bork_lib
 {
-    template<typename RandAccIter>
-    RandAccIter partition(RandAccIter low, RandAccIter high)
+    template<typename RandAccIter, typename Compare = std::less<>>
+    RandAccIter partition(RandAccIter low, RandAccIter high, Compare comp = Compare{})
     {
-        auto pivot = low;
+        auto pivot = *low;   // by value, since the first swap moves *low
         auto i = std::prev(low);
         auto j = high;
 
         while (true) {
             do {
                 ++i;
-            } while (*i < *pivot);
+            } while (comp(*i, pivot));
             do {
                 --j;
-            } while (*j > *pivot);
+            } while (comp(pivot, *j));
             
             if (i >= j) {
                 return j;
@@ -27,15 +33,46 @@ namespace bork_lib
         }
     }
 
-    template<typename RandAccIter>
-    void quicksort_hoare(RandAccIter low, RandAccIter high)
+    /* Quicksort ordered by comp applied to the projected elements. It recurses into the
+     * smaller part and loops on the larger one, so sorted input, which makes every pivot
+     * the minimum, costs quadratic time but only logarithmic stack depth. */
+    template<typename RandAccIter, PartitionScheme scheme = PartitionScheme::classic,
+             typename LeafSort = NoLeafSort, typename Compare, typename Proj = Identity>
+    void quicksort_hoare(RandAccIter low, RandAccIter high, Compare comp, Proj proj = Proj{})
     {
-        if (high - 1 <= low)
-            return;
+        auto less = make_projected_compare(std::move(comp), std::move(proj));
+        while (high - low > LeafSort::max_size) {
+            RandAccIter left_end, right_begin;
+            if constexpr (scheme == PartitionScheme::block) {
+                auto p = block_partition(low, high, less);
+                left_end = p;
+                right_begin = p + 1;
+            } else if constexpr (scheme == PartitionScheme::three_way) {
+                auto p = three_way_partition(low, high, less);
+                left_end = p.first;
+                right_begin = p.second;
+            } else {
+                auto p = bork_lib::partition(low, high, less);
+                left_end = p + 1;
+                right_begin = p + 1;
+            }
+
+            if (left_end - low < high - right_begin) {
+                quicksort_hoare<RandAccIter, scheme, LeafSort>(low, left_end, less);
+                low = right_begin;
+            } else {
+                quicksort_hoare<RandAccIter, scheme, LeafSort>(right_begin, high, less);
+                high = left_end;
+            }
+        }
+        LeafSort::sort(low, high, less);
+    }
 
-        auto p = partition(low, high);
-        quicksort_hoare(low, p + 1);
-        quicksort_hoare(p + 1, high);
+    template<typename RandAccIter, PartitionScheme scheme = PartitionScheme::classic,
+             typename LeafSort = NoLeafSort>
+    void quicksort_hoare(RandAccIter low, RandAccIter high)
+    {
+        quicksort_hoare<RandAccIter, scheme, LeafSort>(low, high, std::less<>{});
     }
 }
 
@@ -1,19 +1,25 @@
 #ifndef QUICKSORT_LOMUTO_HPP
 #define QUICKSORT_LOMUTO_HPP
 
+#include <functional>
 #include <iterator>
 #include <iostream>
+#include <utility>
+#include "block-partition.hpp"
+#include "projection.hpp"
+#include "three-way-partition.hpp"
 
 namespace bork_lib
 {
-    template<typename RandAccIter>
-    RandAccIter partition(RandAccIter low, RandAccIter high)
+    /* Lomuto partition around the last element. Returns the final position of the pivot. */
+    template<typename RandAccIter, typename Compare = std::less<>>
+    RandAccIter lomuto_partition(RandAccIter low, RandAccIter high, Compare comp = Compare{})
     {
         auto pivot = std::prev(high);
         auto i = std::prev(low);
 
         for (auto j = low; j != high - 1; ++j) {
-            if (*j <= *pivot) {
+            if (!comp(*pivot, *j)) {
                 ++i;
                 std::iter_swap(i, j);
             }
@@ -23,15 +29,44 @@ namespace bork_lib
         return i + 1;
     }
 
-    template<typename RandAccIter>
-    void quicksort_lomuto(RandAccIter low, RandAccIter high)
+    /* Quicksort ordered by comp applied to the projected elements. It recurses into the
+     * smaller part and loops on the larger one, so sorted input, which makes every pivot
+     * the maximum, costs quadratic time but only logarithmic stack depth. The block scheme
+     * is a Hoare-style partition, so it is only offered by quicksort_hoare. */
+    template<typename RandAccIter, PartitionScheme scheme = PartitionScheme::classic,
+             typename Compare, typename Proj = Identity>
+    void quicksort_lomuto(RandAccIter low, RandAccIter high, Compare comp, Proj proj = Proj{})
     {
-        if (high - 1 <= low)
-            return;
+        static_assert(scheme != PartitionScheme::block,
+                      "block partitioning is not a Lomuto partition, use quicksort_hoare");
+        auto less = make_projected_compare(std::move(comp), std::move(proj));
+        while (high - low >= 2) {
+            RandAccIter left_end, right_begin;
+            if constexpr (scheme == PartitionScheme::three_way) {
+                std::iter_swap(low, high - 1);   // keep the last element as the pivot
+                auto p = three_way_partition(low, high, less);
+                left_end = p.first;
+                right_begin = p.second;
+            } else {
+                auto p = lomuto_partition(low, high, less);
+                left_end = p;
+                right_begin = p + 1;
+            }
+
+            if (left_end - low < high - right_begin) {
+                quicksort_lomuto<RandAccIter, scheme>(low, left_end, less);
+                low = right_begin;
+            } else {
+                quicksort_lomuto<RandAccIter, scheme>(right_begin, high, less);
+                high = left_end;
+            }
+        }
+    }
 
-        auto p = partition(low, high);
-        quicksort_lomuto(low, p);
-        quicksort_lomuto(p + 1, high);
+    template<typename RandAccIter, PartitionScheme scheme = PartitionScheme::classic>
+    void quicksort_lomuto(RandAccIter low, RandAccIter high)
+    {
+        quicksort_lomuto<RandAccIter, scheme>(low, high, std::less<>{});
     }
 }
 
@@ -1,51 +1,76 @@
 #ifndef QUICKSORT_RANDOM_HPP
 #define QUICKSORT_RANDOM_HPP
 
+#include <functional>
 #include <iterator>
 #include <random>
+#include <utility>
+#include "block-partition.hpp"
+#include "projection.hpp"
+#include "quicksort-hoare.hpp"
+#include "three-way-partition.hpp"
 
 namespace bork_lib
 {
-    template<typename InputIterator>
-    InputIterator partition(InputIterator low, InputIterator high)
+    /* Moves a uniformly chosen pivot to the front of the range. */
+    template<typename InputIterator, typename URBG>
+    void choose_random_pivot(InputIterator low, InputIterator high, URBG& re)
     {
-        auto pivot = low;
-        auto leftIndex = low - 1;
-        auto rightIndex = high;
-
-        while (true)
-        {
-            do {
-                ++leftIndex;
-            } while (*leftIndex < *pivot);
-            do {
-                --rightIndex;
-            } while (*rightIndex > *pivot);
-                if (leftIndex >= rightIndex)
-                    return rightIndex;
-            std::iter_swap(leftIndex, rightIndex);
-        }
+        std::uniform_int_distribution<typename std::iterator_traits<InputIterator>::difference_type> dist{0, high - low - 1};
+        std::iter_swap(low, low + dist(re));
     }
 
-    template<typename InputIterator>
-    InputIterator randomized_partition(InputIterator low, InputIterator high)
+    template<typename InputIterator, PartitionScheme scheme = PartitionScheme::classic, typename URBG,
+             typename Compare = std::less<>>
+    InputIterator randomized_partition(InputIterator low, InputIterator high, URBG& re, Compare comp = Compare{})
     {
-        std::default_random_engine re {};
-        std::uniform_int_distribution<> dist{0, high - low - 1};
-        auto pivot = low + dist(re);
-        std::iter_swap(low, pivot);
-        return partition(low, high);
+        choose_random_pivot(low, high, re);
+        if constexpr (scheme == PartitionScheme::block) {
+            return block_partition(low, high, comp);
+        } else {
+            return bork_lib::partition(low, high, comp);
+        }
     }
 
-    template<typename InputIterator>
-    void quicksort_random(InputIterator low, InputIterator high)
+    /* Sorts the range with pivots drawn from the caller's random engine, which keeps its
+     * state across the whole sort. Seeding it makes the sort reproducible. The order is given
+     * by comp applied to the projected elements. */
+    template<typename InputIterator, PartitionScheme scheme = PartitionScheme::classic, typename URBG,
+             typename Compare, typename Proj = Identity>
+    void quicksort_random(InputIterator low, InputIterator high, URBG& re, Compare comp, Proj proj = Proj{})
     {
-        if (high - 1 <= low)
+        if (high - low < 2)
             return;
 
-        auto p = randomized_partition(low, high);
-        quicksort_random(low, p + 1);
-        quicksort_random(p + 1, high);
+        auto less = make_projected_compare(std::move(comp), std::move(proj));
+        if constexpr (scheme == PartitionScheme::three_way) {
+            choose_random_pivot(low, high, re);
+            auto p = three_way_partition(low, high, less);
+            quicksort_random<InputIterator, scheme>(low, p.first, re, less);
+            quicksort_random<InputIterator, scheme>(p.second, high, re, less);
+        } else {
+            auto p = randomized_partition<InputIterator, scheme>(low, high, re, less);
+            if constexpr (scheme == PartitionScheme::block) {
+                quicksort_random<InputIterator, scheme>(low, p, re, less);
+            } else {
+                quicksort_random<InputIterator, scheme>(low, p + 1, re, less);
+            }
+            quicksort_random<InputIterator, scheme>(p + 1, high, re, less);
+        }
+    }
+
+    template<typename InputIterator, PartitionScheme scheme = PartitionScheme::classic, typename URBG>
+    void quicksort_random(InputIterator low, InputIterator high, URBG& re)
+    {
+        quicksort_random<InputIterator, scheme>(low, high, re, std::less<>{});
+    }
+
+    /* Sorts the range with a random engine seeded once from std::random_device. */
+    template<typename InputIterator, PartitionScheme scheme = PartitionScheme::classic>
+    void quicksort_random(InputIterator low, InputIterator high)
+    {
+        std::mt19937 re{std::random_device{}()};
+        quicksort_random<InputIterator, scheme>(low, high, re);
     }
 }
 
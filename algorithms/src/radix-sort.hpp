@@ -0,0 +1,223 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bork_lib
+{
+
+/* Maps a key to an unsigned integer whose natural order matches the key's order. */
+template<typename T, typename = void>
+struct RadixTraits;
+
+template<typename T>
+struct RadixTraits<T, std::enable_if_t<std::is_integral_v<T>>>
+{
+    using key_type = std::make_unsigned_t<T>;
+    static constexpr key_type sign_bit = static_cast<key_type>(key_type{1} << (8 * sizeof(T) - 1));
+
+    static key_type key(T value)
+    {
+        if constexpr (std::is_signed_v<T>) {
+            return static_cast<key_type>(static_cast<key_type>(value) ^ sign_bit);   // move negatives below positives
+        } else {
+            return value;
+        }
+    }
+};
+
+template<typename T>
+struct RadixTraits<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    static_assert(std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8),
+                  "radix sort supports IEEE 754 single and double precision");
+    using key_type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    static constexpr key_type sign_bit = static_cast<key_type>(key_type{1} << (8 * sizeof(T) - 1));
+
+    /* Sign-flip trick: negative values have every bit inverted so that larger magnitudes
+     * sort lower, positive values only have the sign bit set. */
+    static key_type key(T value)
+    {
+        key_type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & sign_bit) ? static_cast<key_type>(~bits) : static_cast<key_type>(bits | sign_bit);
+    }
+};
+
+constexpr std::ptrdiff_t radix_insertion_threshold = 32;
+
+/* Returns the given byte of the value's radix key, counting from the least significant. */
+template<typename T>
+std::size_t radix_digit(const T& value, std::size_t byte)
+{
+    return static_cast<std::size_t>((RadixTraits<T>::key(value) >> (8 * byte)) & 0xFF);
+}
+
+/* Private function that insertion-sorts a short range by radix key. */
+template<typename RandAccIter>
+void radix_insertion_sort(RandAccIter low, RandAccIter high)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    for (auto i = low; i != high; ++i) {
+        auto value = std::move(*i);
+        auto key = RadixTraits<T>::key(value);
+        auto j = i;
+        for (; j != low && key < RadixTraits<T>::key(*(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(value);
+    }
+}
+
+/* Least significant digit radix sort. The histograms of every byte are built in a single
+ * read of the input, and passes in which all keys share a digit are skipped. Stable, and
+ * needs a buffer of high - low elements. */
+template<typename RandAccIter>
+void radix_sort_lsd(RandAccIter low, RandAccIter high)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    using Key = typename RadixTraits<T>::key_type;
+    constexpr std::size_t passes = sizeof(Key);
+    auto n = static_cast<std::size_t>(high - low);
+    if (n < 2) {
+        return;
+    }
+
+    std::vector<std::array<std::size_t, 256>> counts(passes);
+    for (auto it = low; it != high; ++it) {
+        auto key = RadixTraits<T>::key(*it);
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            ++counts[pass][(key >> (8 * pass)) & 0xFF];
+        }
+    }
+
+    std::vector<T> buffer(n);
+    auto scatter = [](auto src, auto src_end, auto dst, std::array<std::size_t, 256>& offsets, std::size_t pass) {
+        for (; src != src_end; ++src) {
+            auto digit = radix_digit(*src, pass);
+            dst[static_cast<std::ptrdiff_t>(offsets[digit]++)] = std::move(*src);
+        }
+    };
+
+    bool in_buffer = false;
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        auto& offsets = counts[pass];
+        bool trivial = false;
+        std::size_t sum = 0;
+        for (auto& count : offsets) {
+            trivial = trivial || count == n;
+            auto start = sum;
+            sum += count;
+            count = start;
+        }
+        if (trivial) {
+            continue;
+        }
+
+        if (in_buffer) {
+            scatter(buffer.begin(), buffer.end(), low, offsets, pass);
+        } else {
+            scatter(low, high, buffer.begin(), offsets, pass);
+        }
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        std::move(buffer.begin(), buffer.end(), low);
+    }
+}
+
+/* Private function that distributes the range into 256 buckets by the given byte in place,
+ * following cycles of misplaced elements, then recurses on each bucket with the next
+ * lower byte. Bytes on which every key agrees are skipped. */
+template<typename RandAccIter>
+void american_flag_sort(RandAccIter low, RandAccIter high, std::size_t byte)
+{
+    auto n = high - low;
+    if (n <= radix_insertion_threshold) {
+        radix_insertion_sort(low, high);
+        return;
+    }
+
+    std::array<std::ptrdiff_t, 256> counts{};
+    while (true) {
+        counts.fill(0);
+        for (auto it = low; it != high; ++it) {
+            ++counts[radix_digit(*it, byte)];
+        }
+
+        bool trivial = false;
+        for (auto count : counts) {
+            trivial = trivial || count == n;
+        }
+        if (!trivial) {
+            break;
+        }
+        if (byte == 0) {
+            return;
+        }
+        --byte;
+    }
+
+    std::array<std::ptrdiff_t, 256> heads{}, tails{};
+    std::ptrdiff_t sum = 0;
+    for (std::size_t b = 0; b < 256; ++b) {
+        heads[b] = sum;
+        sum += counts[b];
+        tails[b] = sum;
+    }
+
+    for (std::size_t b = 0; b < 256; ++b) {
+        while (heads[b] < tails[b]) {
+            auto digit = radix_digit(low[heads[b]], byte);
+            if (digit == b) {
+                ++heads[b];
+            } else {
+                std::iter_swap(low + heads[b], low + heads[digit]++);
+            }
+        }
+    }
+
+    if (byte == 0) {
+        return;
+    }
+    std::ptrdiff_t start = 0;
+    for (std::size_t b = 0; b < 256; ++b) {
+        if (counts[b] > 1) {
+            american_flag_sort(low + start, low + start + counts[b], byte - 1);
+        }
+        start += counts[b];
+    }
+}
+
+/* Most significant digit radix sort (American flag sort). Works in place with O(1)
+ * extra memory per recursion level, but is not stable. */
+template<typename RandAccIter>
+void radix_sort_msd(RandAccIter low, RandAccIter high)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    if (high - low < 2) {
+        return;
+    }
+
+    american_flag_sort(low, high, sizeof(typename RadixTraits<T>::key_type) - 1);
+}
+
+/* Sorts integral or floating-point keys with the least significant digit radix sort. */
+template<typename RandAccIter>
+void radix_sort(RandAccIter low, RandAccIter high)
+{
+    radix_sort_lsd(low, high);
+}
+
+} // end namespace
+
+#endif
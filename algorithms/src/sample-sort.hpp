@@ -0,0 +1,212 @@
+#ifndef SAMPLE_SORT_HPP
+#define SAMPLE_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+#include "introsort.hpp"
+#include "thread-pool.hpp"
+
+namespace bork_lib
+{
+
+constexpr std::ptrdiff_t sample_sort_cutoff = 1 << 14;
+constexpr std::ptrdiff_t sample_sort_max_buckets = 256;
+constexpr std::ptrdiff_t sample_sort_oversampling = 16;
+constexpr std::ptrdiff_t sample_sort_stripe = 1 << 16;
+constexpr int sample_sort_max_depth = 8;
+
+/* Classifies elements into k buckets (k a power of two) with a search tree of k - 1
+ * splitters stored in breadth-first (Eytzinger) order. Descending the tree is one
+ * comparison per level whose result is added to the index, so there are no branches to
+ * mispredict. Bucket b holds the elements in (splitter[b - 1], splitter[b]]. When the
+ * sample contains duplicate splitters, every bucket is split into two, and the elements
+ * equal to a splitter go to an equality bucket that needs no further sorting. */
+template<typename T>
+class SampleClassifier
+{
+private:
+    std::vector<T> tree;
+    std::vector<T> sorted_splitters;
+    std::size_t num_buckets;
+    int levels;
+    bool equal_buckets;
+
+public:
+    SampleClassifier(std::vector<T> splitters, std::size_t num_buckets);
+    std::size_t bucket_count() const noexcept { return equal_buckets ? 2 * num_buckets : num_buckets; }
+    bool is_equality_bucket(std::size_t bucket) const noexcept { return equal_buckets && bucket % 2 == 1; }
+    std::size_t classify(const T& value) const;
+};
+
+/* Constructor. Takes the num_buckets - 1 sorted splitters. */
+template<typename T>
+SampleClassifier<T>::SampleClassifier(std::vector<T> splitters, std::size_t num_buckets)
+  : tree(num_buckets), sorted_splitters{std::move(splitters)}, num_buckets{num_buckets}, levels{0},
+    equal_buckets{false}
+{
+    for (auto k = num_buckets; k > 1; k /= 2) {
+        ++levels;
+    }
+    for (std::size_t i = 1; i < sorted_splitters.size(); ++i) {
+        if (!(sorted_splitters[i - 1] < sorted_splitters[i])) {
+            equal_buckets = true;
+        }
+    }
+
+    // lay the sorted splitters out as a complete binary search tree rooted at index 1
+    std::size_t next = 0;
+    auto fill = [&](auto& self, std::size_t node) -> void {
+        if (node >= num_buckets) {
+            return;
+        }
+        self(self, 2 * node);
+        tree[node] = sorted_splitters[next++];
+        self(self, 2 * node + 1);
+    };
+    fill(fill, 1);
+}
+
+/* Returns the bucket of a value. */
+template<typename T>
+std::size_t SampleClassifier<T>::classify(const T& value) const
+{
+    std::size_t node = 1;
+    for (int level = 0; level < levels; ++level) {
+        node = 2 * node + static_cast<std::size_t>(tree[node] < value);
+    }
+    auto bucket = node - num_buckets;
+    if (!equal_buckets) {
+        return bucket;
+    }
+    return 2 * bucket + (bucket < sorted_splitters.size() && !(value < sorted_splitters[bucket]));
+}
+
+/* Private function that distributes the range into buckets through the buffer and
+ * recurses on every bucket as a separate task. Stripes of the range are classified and
+ * counted in parallel, then every stripe scatters its elements to the exclusive offsets
+ * computed for it, so no two threads write the same location. */
+template<typename RandAccIter, typename BufferIter>
+void sample_sort_util(RandAccIter low, RandAccIter high, BufferIter buffer, ThreadPool& pool, int depth)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    auto n = high - low;
+    if (n <= sample_sort_cutoff || depth >= sample_sort_max_depth) {
+        introsort(low, high);
+        return;
+    }
+
+    std::ptrdiff_t num_buckets = 2;
+    while (num_buckets < sample_sort_max_buckets && n / (2 * num_buckets) >= sample_sort_cutoff / 4) {
+        num_buckets *= 2;
+    }
+
+    std::mt19937 re{static_cast<std::mt19937::result_type>(n)};
+    auto sample_size = std::min(n, num_buckets * sample_sort_oversampling);
+    for (std::ptrdiff_t i = 0; i < sample_size; ++i) {   // move a random sample to the front
+        std::uniform_int_distribution<std::ptrdiff_t> dist{i, n - 1};
+        std::iter_swap(low + i, low + dist(re));
+    }
+    introsort(low, low + sample_size);
+    std::vector<T> splitters;
+    for (std::ptrdiff_t i = 1; i < num_buckets; ++i) {
+        splitters.push_back(low[i * sample_size / num_buckets]);
+    }
+    SampleClassifier<T> classifier{std::move(splitters), static_cast<std::size_t>(num_buckets)};
+    auto buckets = classifier.bucket_count();
+
+    auto stripes = std::max<std::ptrdiff_t>(1, std::min(static_cast<std::ptrdiff_t>(pool.size()), n / sample_sort_stripe));
+    std::vector<std::uint16_t> oracle(static_cast<std::size_t>(n));
+    std::vector<std::vector<std::ptrdiff_t>> offsets(static_cast<std::size_t>(stripes),
+                                                     std::vector<std::ptrdiff_t>(buckets, 0));
+    auto stripe_begin = [n, stripes](std::ptrdiff_t s) { return n * s / stripes; };
+    {
+        TaskGroup group{pool};
+        for (std::ptrdiff_t s = 0; s < stripes; ++s) {
+            group.run([&, s] {
+                auto& counts = offsets[static_cast<std::size_t>(s)];
+                for (auto i = stripe_begin(s); i < stripe_begin(s + 1); ++i) {
+                    auto bucket = classifier.classify(low[i]);
+                    oracle[static_cast<std::size_t>(i)] = static_cast<std::uint16_t>(bucket);
+                    ++counts[bucket];
+                }
+            });
+        }
+        group.wait();
+    }
+
+    std::vector<std::ptrdiff_t> bucket_starts(buckets + 1, 0);
+    std::ptrdiff_t sum = 0;
+    for (std::size_t b = 0; b < buckets; ++b) {
+        bucket_starts[b] = sum;
+        for (auto& stripe_offsets : offsets) {
+            auto count = stripe_offsets[b];
+            stripe_offsets[b] = sum;
+            sum += count;
+        }
+    }
+    bucket_starts[buckets] = n;
+
+    {
+        TaskGroup group{pool};
+        for (std::ptrdiff_t s = 0; s < stripes; ++s) {
+            group.run([&, s] {
+                auto& next = offsets[static_cast<std::size_t>(s)];
+                for (auto i = stripe_begin(s); i < stripe_begin(s + 1); ++i) {
+                    buffer[next[oracle[static_cast<std::size_t>(i)]]++] = std::move(low[i]);
+                }
+            });
+        }
+        group.wait();
+    }
+    oracle = std::vector<std::uint16_t>{};
+
+    TaskGroup group{pool};
+    for (std::size_t b = 0; b < buckets; ++b) {
+        auto begin = bucket_starts[b];
+        auto end = bucket_starts[b + 1];
+        if (begin == end) {
+            continue;
+        }
+        auto recurse = !classifier.is_equality_bucket(b);
+        group.run([=, &pool] {
+            std::move(buffer + begin, buffer + end, low + begin);
+            if (recurse) {
+                sample_sort_util(low + begin, low + end, buffer + begin, pool, depth + 1);
+            }
+        });
+    }
+    group.wait();
+}
+
+/* Parallel samplesort on the given pool. A sorted random sample provides up to 255
+ * splitters, elements are classified with a branch-free search tree and scattered to
+ * their buckets in parallel, and the buckets are sorted recursively as independent tasks.
+ * Uses one buffer of high - low elements. */
+template<typename RandAccIter>
+void sample_sort(RandAccIter low, RandAccIter high, ThreadPool& pool)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    if (high - low <= sample_sort_cutoff) {
+        introsort(low, high);
+        return;
+    }
+
+    std::vector<T> buffer(static_cast<std::size_t>(high - low));
+    sample_sort_util(low, high, buffer.begin(), pool, 0);
+}
+
+/* Parallel samplesort on the shared pool. */
+template<typename RandAccIter>
+void sample_sort(RandAccIter low, RandAccIter high)
+{
+    sample_sort(low, high, ThreadPool::shared());
+}
+
+} // end namespace
+
+#endif
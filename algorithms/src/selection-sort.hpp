@@ -2,18 +2,22 @@
 #define SELECTIONSORT_H
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
+#include <utility>
+#include "projection.hpp"
 
-template<typename InputIterator>
-void selection_sort(InputIterator low, InputIterator high)
+template<typename InputIterator, typename Compare, typename Proj = bork_lib::Identity>
+void selection_sort(InputIterator low, InputIterator high, Compare comp, Proj proj = Proj{})
 {
+    auto less = bork_lib::make_projected_compare(std::move(comp), std::move(proj));
     for (auto i = low; i != high; ++i) {
         using T = typename std::iterator_traits<InputIterator>::value_type;
         T min = *i;
         auto minIndex = i;
 
         for (auto j = i; j != high; ++j) {
-            if (*j < min) {
+            if (less(*j, min)) {
                 min = *j;
                 minIndex = j;
             }
@@ -23,4 +27,10 @@ void selection_sort(InputIterator low, InputIterator high)
     }
 }
 
+template<typename InputIterator>
+void selection_sort(InputIterator low, InputIterator high)
+{
+    selection_sort(low, high, std::less<>{});
+}
+
 #endif
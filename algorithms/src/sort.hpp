@@ -0,0 +1,124 @@
+#ifndef SORT_HPP
+#define SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "adaptive-merge-sort.hpp"
+#include "introsort.hpp"
+#include "leaf-sort.hpp"
+#include "merge-sort.hpp"
+#include "projection.hpp"
+#include "radix-sort.hpp"
+#include "string-sort.hpp"
+
+namespace bork_lib
+{
+
+/* bork_lib::sort picks an algorithm for the caller. At compile time it looks at the iterator
+ * category, the element type and whether the order is the natural one; at run time at the
+ * length of the range and at how presorted it already is. Call it qualified, since ADL
+ * would also find std::sort. */
+
+constexpr std::ptrdiff_t sort_radix_threshold = 1 << 10;
+constexpr std::ptrdiff_t sort_presorted_ratio = 64;   // at most n / 64 runs counts as presorted
+
+/* Whether the comparator orders T ascending or descending by its own operator<. */
+template<typename T, typename Compare>
+constexpr bool is_ascending_order_v = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+template<typename T, typename Compare>
+constexpr bool is_descending_order_v = std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>>;
+
+/* Whether T has a radix key (see RadixTraits). */
+template<typename T>
+constexpr bool is_radix_sortable_v = (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                                     (std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 &&
+                                      (sizeof(T) == 4 || sizeof(T) == 8));
+
+/* Whether T is a string whose operator< is byte order. */
+template<typename T>
+constexpr bool is_byte_string_v = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+/* Returns whether the range is made of at most n / sort_presorted_ratio ascending or strictly
+ * descending runs. The scan gives up as soon as there are more, so on unsorted input it
+ * reads only a small fraction of the range. */
+template<typename RandAccIter, typename Compare>
+bool is_presorted(RandAccIter low, RandAccIter high, Compare comp)
+{
+    auto max_runs = (high - low) / sort_presorted_ratio;
+    std::ptrdiff_t runs = 0;
+    for (auto i = low; i != high;) {
+        if (++runs > max_runs) {
+            return false;
+        }
+
+        auto start = i++;
+        if (i != high && comp(*i, *start)) {
+            for (++i; i != high && comp(*i, *(i - 1)); ++i);
+        } else {
+            for (; i != high && !comp(*i, *(i - 1)); ++i);
+        }
+    }
+    return true;
+}
+
+/* Sorts the range, ordered by comp applied to the projected elements. Not stable.
+ * - iterators that are not random access: merge sort
+ * - up to 16 elements: insertion sort
+ * - few ascending or descending runs: adaptive merge sort
+ * - integers and IEEE floats in natural or reverse order: LSD radix sort
+ * - std::string and std::string_view in natural order: cached multikey quicksort
+ * - everything else: introsort */
+template<typename Iter, typename Compare, typename Proj = Identity>
+void sort(Iter low, Iter high, Compare comp, Proj proj = Proj{})
+{
+    using T = typename std::iterator_traits<Iter>::value_type;
+    using Category = typename std::iterator_traits<Iter>::iterator_category;
+    auto less = make_projected_compare(std::move(comp), std::move(proj));
+    if constexpr (!std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+        merge_sort(low, high, less);
+    } else {
+        auto n = high - low;
+        if (n <= InsertionLeafSort::max_size) {
+            insertion_sort_move(low, high, less);
+            return;
+        }
+        if (is_presorted(low, high, less)) {
+            adaptive_merge_sort(low, high, less);
+            return;
+        }
+
+        constexpr bool natural = std::is_same_v<Proj, Identity>;
+        if constexpr (natural && is_radix_sortable_v<T> &&
+                      (is_ascending_order_v<T, Compare> || is_descending_order_v<T, Compare>)) {
+            if (n >= sort_radix_threshold) {
+                radix_sort_lsd(low, high);
+                if constexpr (is_descending_order_v<T, Compare>) {
+                    std::reverse(low, high);
+                }
+                return;
+            }
+        } else if constexpr (natural && is_byte_string_v<T> && is_ascending_order_v<T, Compare>) {
+            cached_multikey_quicksort(low, high);
+            return;
+        }
+        introsort(low, high, less);
+    }
+}
+
+template<typename Iter>
+void sort(Iter low, Iter high)
+{
+    bork_lib::sort(low, high, std::less<>{});
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef SORTING_NETWORK_HPP
+#define SORTING_NETWORK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include "leaf-sort.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace bork_lib
+{
+
+constexpr std::ptrdiff_t sorting_network_size = 64;
+
+#if defined(__AVX2__)
+
+/* AVX2 operations on eight 32-bit integers. */
+struct Avx2Int32
+{
+    using value_type = std::int32_t;
+    using reg = __m256i;
+
+    static value_type pad() { return std::numeric_limits<value_type>::max(); }
+    static reg load(const value_type* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(value_type* p, reg v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    static reg reverse(reg v) { return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+    static reg swap_halves(reg v) { return _mm256_permute2x128_si256(v, v, 1); }
+    static reg swap_pairs(reg v) { return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+    static reg swap_adjacent(reg v) { return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)); }
+    template<int mask> static reg blend(reg a, reg b) { return _mm256_blend_epi32(a, b, mask); }
+    static __m256 to_ps(reg v) { return _mm256_castsi256_ps(v); }
+    static reg from_ps(__m256 v) { return _mm256_castps_si256(v); }
+};
+
+/* AVX2 operations on eight single precision floats. NaNs are not supported. */
+struct Avx2Float
+{
+    using value_type = float;
+    using reg = __m256;
+
+    static value_type pad() { return std::numeric_limits<value_type>::infinity(); }
+    static reg load(const value_type* p) { return _mm256_load_ps(p); }
+    static void store(value_type* p, reg v) { _mm256_store_ps(p, v); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static reg reverse(reg v) { return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+    static reg swap_halves(reg v) { return _mm256_permute2f128_ps(v, v, 1); }
+    static reg swap_pairs(reg v) { return _mm256_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+    static reg swap_adjacent(reg v) { return _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1)); }
+    template<int mask> static reg blend(reg a, reg b) { return _mm256_blend_ps(a, b, mask); }
+    static __m256 to_ps(reg v) { return v; }
+    static reg from_ps(__m256 v) { return v; }
+};
+
+/* Puts the lane-wise minimum in a and the maximum in b. */
+template<typename Vec>
+void vector_compare_swap(typename Vec::reg& a, typename Vec::reg& b)
+{
+    auto lo = Vec::min(a, b);
+    b = Vec::max(a, b);
+    a = lo;
+}
+
+/* Sorts a bitonic register with half-cleaners at distances 4, 2 and 1. */
+template<typename Vec>
+typename Vec::reg vector_bitonic_cleanup(typename Vec::reg v)
+{
+    auto p = Vec::swap_halves(v);
+    v = Vec::template blend<0xF0>(Vec::min(v, p), Vec::max(v, p));
+    p = Vec::swap_pairs(v);
+    v = Vec::template blend<0xCC>(Vec::min(v, p), Vec::max(v, p));
+    p = Vec::swap_adjacent(v);
+    return Vec::template blend<0xAA>(Vec::min(v, p), Vec::max(v, p));
+}
+
+/* Transposes an 8x8 matrix held in eight registers. */
+template<typename Vec>
+void vector_transpose(typename Vec::reg* r)
+{
+    __m256 t[8], s[8];
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_ps(Vec::to_ps(r[i]), Vec::to_ps(r[i + 1]));
+        t[i + 1] = _mm256_unpackhi_ps(Vec::to_ps(r[i]), Vec::to_ps(r[i + 1]));
+    }
+    for (int i = 0; i < 8; i += 4) {
+        s[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        s[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        s[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        s[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int i = 0; i < 4; ++i) {
+        r[i] = Vec::from_ps(_mm256_permute2f128_ps(s[i], s[i + 4], 0x20));
+        r[i + 4] = Vec::from_ps(_mm256_permute2f128_ps(s[i], s[i + 4], 0x31));
+    }
+}
+
+/* Merges two sorted runs of k registers each (r[0, k) and r[k, 2k)) with a bitonic
+ * merge: the second run is reversed, the runs are split into lower and upper halves by
+ * a lane-wise min/max, and both halves are cleaned up across and then within registers. */
+template<typename Vec>
+void vector_merge_runs(typename Vec::reg* r, int k)
+{
+    typename Vec::reg reversed[4];
+    for (int j = 0; j < k; ++j) {
+        reversed[j] = Vec::reverse(r[2 * k - 1 - j]);
+    }
+    for (int j = 0; j < k; ++j) {
+        r[k + j] = Vec::max(r[j], reversed[j]);
+        r[j] = Vec::min(r[j], reversed[j]);
+    }
+
+    for (int half = 0; half < 2 * k; half += k) {
+        for (int d = k / 2; d >= 1; d /= 2) {
+            for (int j = 0; j < k; ++j) {
+                if ((j & d) == 0) {
+                    vector_compare_swap<Vec>(r[half + j], r[half + j + d]);
+                }
+            }
+        }
+        for (int j = 0; j < k; ++j) {
+            r[half + j] = vector_bitonic_cleanup<Vec>(r[half + j]);
+        }
+    }
+}
+
+/* Sorts up to 64 values by padding them to an 8x8 matrix: an optimal 19-comparator
+ * network sorts the columns, a transpose turns them into eight sorted registers, and
+ * three rounds of bitonic merges combine those into one run. */
+template<typename Vec, typename RandAccIter>
+void vector_network_sort(RandAccIter low, RandAccIter high)
+{
+    using T = typename Vec::value_type;
+    alignas(32) T values[sorting_network_size];
+    auto n = high - low;
+    for (std::ptrdiff_t i = 0; i < sorting_network_size; ++i) {
+        values[i] = i < n ? low[i] : Vec::pad();
+    }
+
+    typename Vec::reg r[8];
+    for (int i = 0; i < 8; ++i) {
+        r[i] = Vec::load(values + 8 * i);
+    }
+
+    static constexpr int network[19][2] = {
+        {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}, {0, 1}, {2, 3},
+        {4, 5}, {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6}, {1, 2}, {3, 4}, {5, 6}
+    };
+    for (const auto& comparator : network) {
+        vector_compare_swap<Vec>(r[comparator[0]], r[comparator[1]]);
+    }
+    vector_transpose<Vec>(r);
+    for (int k = 1; k < 8; k *= 2) {
+        for (int i = 0; i < 8; i += 2 * k) {
+            vector_merge_runs<Vec>(r + i, k);
+        }
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        Vec::store(values + 8 * i, r[i]);
+    }
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        low[i] = values[i];
+    }
+}
+
+#endif
+
+/* Sorts a small range. Ranges of 8 to 64 ints or floats go through the AVX2 sorting
+ * network when the compiler targets AVX2 (e.g. -mavx2 or -march=native) and the order is
+ * the default ascending one; everything else falls back to insertion sort. */
+template<typename RandAccIter, typename Compare = std::less<>>
+void small_sort(RandAccIter low, RandAccIter high, Compare comp = Compare{})
+{
+#if defined(__AVX2__)
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    constexpr bool ascending = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+    auto n = high - low;
+    if (ascending && n >= 8 && n <= sorting_network_size) {
+        if constexpr (std::is_same_v<T, std::int32_t>) {
+            vector_network_sort<Avx2Int32>(low, high);
+            return;
+        } else if constexpr (std::is_same_v<T, float>) {
+            vector_network_sort<Avx2Float>(low, high);
+            return;
+        }
+    }
+#endif
+    insertion_sort_move(low, high, comp);
+}
+
+/* Leaf sorter that hands ranges of up to 64 elements to small_sort. */
+struct NetworkLeafSort
+{
+    static constexpr std::ptrdiff_t max_size = sorting_network_size;
+    template<typename RandAccIter, typename Compare = std::less<>>
+    static void sort(RandAccIter low, RandAccIter high, Compare comp = Compare{}) { small_sort(low, high, comp); }
+};
+
+} // end namespace
+
+#endif
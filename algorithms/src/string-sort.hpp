@@ -0,0 +1,308 @@
+#ifndef STRING_SORT_HPP
+#define STRING_SORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "introsort.hpp"
+
+namespace bork_lib
+{
+
+/* The string sorts work on small references (the characters as a string_view plus the
+ * position in the input) instead of the strings themselves, and compare one character or
+ * one cached word at a time instead of whole strings, so shared prefixes are only
+ * examined once per recursion level. The input is rearranged once at the end. They sort
+ * any range whose elements convert to std::string_view, in byte order. */
+
+constexpr std::ptrdiff_t string_insertion_threshold = 16;
+constexpr std::ptrdiff_t string_radix_threshold = 64;
+
+/* A string to be sorted and its position in the input. */
+struct StringRef
+{
+    std::string_view view;
+    std::size_t index;
+};
+
+/* A string with the eight characters from the current depth cached as a big-endian word. */
+struct CachedStringRef
+{
+    std::uint64_t cache;
+    std::string_view view;
+    std::size_t index;
+};
+
+/* Returns the character at depth shifted up by one, or 0 past the end, so that a string
+ * sorts before all of its extensions. */
+inline int char_at(std::string_view s, std::size_t depth)
+{
+    return depth < s.size() ? static_cast<unsigned char>(s[depth]) + 1 : 0;
+}
+
+/* Returns the eight characters starting at depth as a big-endian word, padded with zeros. */
+inline std::uint64_t cache_at(std::string_view s, std::size_t depth)
+{
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        word <<= 8;
+        if (depth + i < s.size()) {
+            word |= static_cast<unsigned char>(s[depth + i]);
+        }
+    }
+    return word;
+}
+
+/* Private function that builds the references to a range of strings. */
+template<typename Ref, typename RandAccIter>
+std::vector<Ref> make_string_refs(RandAccIter low, RandAccIter high)
+{
+    std::vector<Ref> refs;
+    refs.reserve(static_cast<std::size_t>(high - low));
+    for (auto it = low; it != high; ++it) {
+        Ref ref{};
+        ref.view = std::string_view{*it};
+        ref.index = static_cast<std::size_t>(it - low);
+        refs.push_back(ref);
+    }
+    return refs;
+}
+
+/* Private function that moves the strings into the order of the sorted references by
+ * following the cycles of the permutation, so every string is moved once. */
+template<typename RandAccIter, typename Ref>
+void apply_string_order(RandAccIter low, std::vector<Ref>& refs)
+{
+    using T = typename std::iterator_traits<RandAccIter>::value_type;
+    for (std::size_t start = 0; start < refs.size(); ++start) {
+        if (refs[start].index == start) {
+            continue;
+        }
+
+        T value = std::move(low[static_cast<std::ptrdiff_t>(start)]);
+        auto pos = start;
+        while (refs[pos].index != start) {
+            auto next = refs[pos].index;
+            low[static_cast<std::ptrdiff_t>(pos)] = std::move(low[static_cast<std::ptrdiff_t>(next)]);
+            refs[pos].index = pos;
+            pos = next;
+        }
+        low[static_cast<std::ptrdiff_t>(pos)] = std::move(value);
+        refs[pos].index = pos;
+    }
+}
+
+/* Private function that insertion sorts references whose strings share their first depth
+ * characters. */
+template<typename RandAccIter>
+void string_insertion_sort(RandAccIter low, RandAccIter high, std::size_t depth)
+{
+    if (high - low < 2) {
+        return;
+    }
+
+    for (auto i = low + 1; i != high; ++i) {
+        auto ref = std::move(*i);
+        auto key = ref.view.substr(depth);
+        auto j = i;
+        for (; j != low && key < (j - 1)->view.substr(depth); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(ref);
+    }
+}
+
+/* Private function that partitions the range into the references whose key is less than,
+ * equal to and greater than the pivot key, and returns the bounds of the equal part. */
+template<typename RandAccIter, typename Key, typename GetKey>
+std::pair<RandAccIter, RandAccIter> string_three_way_partition(RandAccIter low, RandAccIter high, Key pivot,
+                                                               GetKey key)
+{
+    auto lt = low;
+    auto i = low;
+    auto gt = high;
+    while (i < gt) {
+        auto k = key(*i);
+        if (k < pivot) {
+            std::iter_swap(lt++, i++);
+        } else if (pivot < k) {
+            std::iter_swap(i, --gt);
+        } else {
+            ++i;
+        }
+    }
+    return {lt, gt};
+}
+
+/* Private function that returns the median of three keys. */
+template<typename Key>
+Key median_key(Key a, Key b, Key c)
+{
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+/* Private function that multikey quicksorts references whose strings share their first
+ * depth characters. */
+template<typename RandAccIter>
+void multikey_quicksort_util(RandAccIter low, RandAccIter high, std::size_t depth)
+{
+    while (high - low > string_insertion_threshold) {
+        auto key = [depth](const StringRef& ref) { return char_at(ref.view, depth); };
+        auto pivot = median_key(key(*low), key(low[(high - low) / 2]), key(*(high - 1)));
+        auto p = string_three_way_partition(low, high, pivot, key);
+        multikey_quicksort_util(low, p.first, depth);
+        multikey_quicksort_util(p.second, high, depth);
+        if (pivot == 0) {   // the equal strings all end here
+            return;
+        }
+        low = p.first;
+        high = p.second;
+        ++depth;
+    }
+
+    string_insertion_sort(low, high, depth);
+}
+
+/* Private function that multikey quicksorts on eight characters at a time. Every reference
+ * holds the word at the current depth, so most comparisons never touch the strings. */
+template<typename RandAccIter>
+void cached_multikey_quicksort_util(RandAccIter low, RandAccIter high, std::size_t depth)
+{
+    while (high - low > string_insertion_threshold) {
+        auto key = [](const CachedStringRef& ref) { return ref.cache; };
+        auto pivot = median_key(key(*low), key(low[(high - low) / 2]), key(*(high - 1)));
+        auto p = string_three_way_partition(low, high, pivot, key);
+        cached_multikey_quicksort_util(low, p.first, depth);
+        cached_multikey_quicksort_util(p.second, high, depth);
+
+        // equal words: strings that end within them only differ in length and sort before
+        // the rest, which continue eight characters further on
+        low = p.first;
+        high = p.second;
+        auto rest = low;
+        for (auto it = low; it != high; ++it) {
+            if (it->view.size() <= depth + 8) {
+                std::iter_swap(it, rest++);
+            }
+        }
+        introsort(low, rest, std::less<>{}, [](const CachedStringRef& ref) { return ref.view.size(); });
+        low = rest;
+        depth += 8;
+        for (auto it = low; it != high; ++it) {
+            it->cache = cache_at(it->view, depth);
+        }
+    }
+
+    string_insertion_sort(low, high, depth);
+}
+
+/* Private function that sorts references whose strings share their first depth characters
+ * by distributing them in place on the character at depth (American flag sort), with one
+ * bucket for the strings that end there. The characters are read once per level into the
+ * oracle, which is permuted along with the references, so counting and distributing do not
+ * touch the strings again. Small buckets go to multikey quicksort. */
+template<typename RandAccIter>
+void string_radix_sort_util(RandAccIter low, RandAccIter high, std::uint16_t* oracle, std::size_t depth)
+{
+    constexpr std::size_t buckets = 257;
+    auto n = high - low;
+    if (n <= string_radix_threshold) {
+        multikey_quicksort_util(low, high, depth);
+        return;
+    }
+
+    std::array<std::ptrdiff_t, buckets> counts{};
+    while (true) {
+        counts.fill(0);
+        for (std::ptrdiff_t i = 0; i < n; ++i) {
+            oracle[i] = static_cast<std::uint16_t>(char_at(low[i].view, depth));
+            ++counts[oracle[i]];
+        }
+        if (counts[0] == n) {   // all strings are equal
+            return;
+        }
+
+        bool trivial = false;
+        for (auto count : counts) {
+            trivial = trivial || count == n;
+        }
+        if (!trivial) {
+            break;
+        }
+        ++depth;
+    }
+
+    std::array<std::ptrdiff_t, buckets> heads{}, tails{};
+    std::ptrdiff_t sum = 0;
+    for (std::size_t b = 0; b < buckets; ++b) {
+        heads[b] = sum;
+        sum += counts[b];
+        tails[b] = sum;
+    }
+
+    for (std::size_t b = 0; b < buckets; ++b) {
+        while (heads[b] < tails[b]) {
+            auto c = oracle[heads[b]];
+            if (c == b) {
+                ++heads[b];
+            } else {
+                auto target = heads[c]++;
+                std::iter_swap(low + heads[b], low + target);
+                std::swap(oracle[heads[b]], oracle[target]);
+            }
+        }
+    }
+
+    std::ptrdiff_t start = counts[0];
+    for (std::size_t b = 1; b < buckets; ++b) {
+        if (counts[b] > 1) {
+            string_radix_sort_util(low + start, low + start + counts[b], oracle + start, depth + 1);
+        }
+        start += counts[b];
+    }
+}
+
+/* Sorts strings with Bentley and Sedgewick's multikey quicksort: a three-way partition on
+ * a single character, where only the equal part moves on to the next character. */
+template<typename RandAccIter>
+void multikey_quicksort(RandAccIter low, RandAccIter high)
+{
+    auto refs = make_string_refs<StringRef>(low, high);
+    multikey_quicksort_util(refs.begin(), refs.end(), 0);
+    apply_string_order(low, refs);
+}
+
+/* Sorts strings with multikey quicksort on cached eight-character words, which suits long
+ * shared prefixes such as URLs. */
+template<typename RandAccIter>
+void cached_multikey_quicksort(RandAccIter low, RandAccIter high)
+{
+    auto refs = make_string_refs<CachedStringRef>(low, high);
+    for (auto& ref : refs) {
+        ref.cache = cache_at(ref.view, 0);
+    }
+    cached_multikey_quicksort_util(refs.begin(), refs.end(), 0);
+    apply_string_order(low, refs);
+}
+
+/* Sorts strings with an in-place MSD radix sort on bytes. */
+template<typename RandAccIter>
+void string_radix_sort(RandAccIter low, RandAccIter high)
+{
+    auto refs = make_string_refs<StringRef>(low, high);
+    std::vector<std::uint16_t> oracle(refs.size());
+    string_radix_sort_util(refs.begin(), refs.end(), oracle.data(), 0);
+    apply_string_order(low, refs);
+}
+
+} // end namespace
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bork_lib
+{
+
+/* A work-stealing thread pool. Every worker owns a deque: it pushes and pops tasks at the
+ * back, while idle workers steal from the front of the other deques. Threads that wait on
+ * a TaskGroup run queued tasks instead of blocking, so nested fork-join cannot deadlock. */
+class ThreadPool
+{
+private:
+    struct WorkQueue
+    {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> next_queue{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_mtx;
+    std::condition_variable sleep_cv;
+
+    static std::size_t& worker_index() { thread_local std::size_t index = no_worker; return index; }
+    static ThreadPool*& worker_pool() { thread_local ThreadPool* pool = nullptr; return pool; }
+    bool pop_task(std::size_t home, std::function<void()>& task);
+    void worker_loop(std::size_t index);
+
+public:
+    static constexpr std::size_t no_worker = static_cast<std::size_t>(-1);
+
+    explicit ThreadPool(std::size_t num_threads = std::max(1u, std::thread::hardware_concurrency()));
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+    static ThreadPool& shared();
+    void submit(std::function<void()> task);
+    bool run_pending_task();
+    std::size_t size() const noexcept { return workers.size(); }
+};
+
+/* Tracks a set of tasks forked onto a pool so that they can be joined. The first exception
+ * thrown by a task is rethrown from wait(). */
+class TaskGroup
+{
+private:
+    ThreadPool& pool;
+    std::atomic<std::size_t> pending{0};
+    std::mutex error_mtx;
+    std::exception_ptr error;
+
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool{pool} {}
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup();
+    template<typename Func> void run(Func&& func);
+    void wait();
+};
+
+/* Starts the worker threads. */
+inline ThreadPool::ThreadPool(std::size_t num_threads)
+{
+    num_threads = std::max<std::size_t>(num_threads, 1);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        workers.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+/* Stops the worker threads. Tasks still queued are discarded. */
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{sleep_mtx};
+        stopping = true;
+    }
+    sleep_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/* Returns the process-wide pool, sized to the hardware concurrency. */
+inline ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+/* Queues a task. Workers push onto their own deque, other threads spread tasks round-robin. */
+inline void ThreadPool::submit(std::function<void()> task)
+{
+    auto index = worker_pool() == this ? worker_index() : next_queue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock{queues[index]->mtx};
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    ++queued;
+    {
+        std::lock_guard<std::mutex> lock{sleep_mtx};
+    }
+    sleep_cv.notify_one();
+}
+
+/* Private function that takes the newest task from the home deque or steals the oldest one
+ * from another deque. */
+inline bool ThreadPool::pop_task(std::size_t home, std::function<void()>& task)
+{
+    if (queued == 0) {
+        return false;
+    }
+
+    if (home != no_worker) {
+        std::lock_guard<std::mutex> lock{queues[home]->mtx};
+        if (!queues[home]->tasks.empty()) {
+            task = std::move(queues[home]->tasks.back());
+            queues[home]->tasks.pop_back();
+            --queued;
+            return true;
+        }
+    }
+
+    auto start = home == no_worker ? 0 : home + 1;
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        auto& victim = *queues[(start + i) % queues.size()];
+        std::lock_guard<std::mutex> lock{victim.mtx};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Runs one queued task on the calling thread. Returns false if there was nothing to run. */
+inline bool ThreadPool::run_pending_task()
+{
+    std::function<void()> task;
+    if (!pop_task(worker_pool() == this ? worker_index() : no_worker, task)) {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+/* Private function executed by every worker thread. */
+inline void ThreadPool::worker_loop(std::size_t index)
+{
+    worker_index() = index;
+    worker_pool() = this;
+    std::function<void()> task;
+    while (true) {
+        if (pop_task(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{sleep_mtx};
+        sleep_cv.wait(lock, [this] { return stopping || queued != 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+/* Waits for outstanding tasks so that none outlives the group. */
+inline TaskGroup::~TaskGroup()
+{
+    while (pending != 0) {
+        if (!pool.run_pending_task()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/* Forks a task onto the pool. */
+template<typename Func>
+void TaskGroup::run(Func&& func)
+{
+    ++pending;
+    pool.submit([this, func = std::forward<Func>(func)]() mutable {
+        try {
+            func();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{error_mtx};
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        --pending;
+    });
+}
+
+/* Joins all forked tasks, running queued work while waiting. */
+inline void TaskGroup::wait()
+{
+    while (pending != 0) {
+        if (!pool.run_pending_task()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (error) {
+        auto e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+} // end namespace
+
+#endif
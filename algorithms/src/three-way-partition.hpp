@@ -0,0 +1,40 @@
+#ifndef THREE_WAY_PARTITION_HPP
+#define THREE_WAY_PARTITION_HPP
+
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace bork_lib
+{
+
+/* Dutch national flag partition around the pivot stored at *low. Returns {lt, gt} such
+ * that [low, lt) < pivot, [lt, gt) == pivot and [gt, high) > pivot, so runs of equal keys
+ * are finished in a single pass instead of being partitioned over and over. */
+template<typename RandAccIter, typename Compare = std::less<>>
+std::pair<RandAccIter, RandAccIter> three_way_partition(RandAccIter low, RandAccIter high, Compare comp = Compare{})
+{
+    auto pivot = *low;
+    auto lt = low;
+    auto i = low + 1;
+    auto gt = high;
+
+    while (i < gt) {
+        if (comp(*i, pivot)) {
+            std::iter_swap(lt, i);
+            ++lt;
+            ++i;
+        } else if (comp(pivot, *i)) {
+            --gt;
+            std::iter_swap(i, gt);
+        } else {
+            ++i;
+        }
+    }
+
+    return {lt, gt};
+}
+
+} // end namespace
+
+#endif
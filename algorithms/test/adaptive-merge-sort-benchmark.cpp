@@ -0,0 +1,7 @@
+#include "benchmark-registry.hpp"
+#include "../src/adaptive-merge-sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar adaptive_merge_sort_benchmark{"adaptive_merge_sort",
+    [](auto low, auto high) { adaptive_merge_sort(low, high); }};
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "benchmark-registry.hpp"
+#include "../src/argsort.hpp"
+
+using namespace bork_lib;
+
+/* Sorts through a permutation, which moves every element once however wide it is. */
+static const SortRegistrar argsort_benchmark{"argsort", [](auto low, auto high) {
+    auto perm = argsort(low, high);
+    apply_permutation(perm, low);
+}};
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchmark-registry.hpp"
+
+using namespace bork_lib;
+
+const char usage[] = R"(Usage: benchmark [options]
+  --list                  print the registered algorithms and the types they support, then exit
+  --algorithms a,b,...    algorithms to run, in this order (default: all); the first one is the
+                          baseline of the speedups
+  --types t,...           element types: int, double, uint64, string, record16, record64,
+                          record256 or all (default: int)
+  --distributions d,...   input distributions, e.g. random,organ-pipe,zipf (default: all)
+  --min n --max n         smallest and largest input sizes (default: 1000 and 100000000)
+  --step n                factor between consecutive sizes (default: 10)
+  --threads n,...         thread counts to run the parallel algorithms with (default: all cores)
+  --json path --csv path  write every result to these files
+Sampling, CPU pinning and hardware counters are set by the BENCHMARK_* environment variables;
+BENCHMARK_CPU pins the timing thread only, the workers of the parallel sorts stay unpinned.
+)";
+
+struct DriverOptions
+{
+    std::vector<std::string> algorithms;
+    std::vector<std::string> types{"int"};
+    std::vector<std::string> distributions;
+    std::vector<int> threads{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+    int min = 1000;
+    int max = 100000000;
+    int step = 10;
+    bool list = false;
+    BenchmarkConfig config;
+};
+
+/* Returns the name with dashes and underscores turned into spaces, so that "organ-pipe" on
+ * the command line names the "organ pipe" distribution. */
+std::string normalize_name(std::string name)
+{
+    std::replace(name.begin(), name.end(), '-', ' ');
+    std::replace(name.begin(), name.end(), '_', ' ');
+    return name;
+}
+
+std::vector<std::string> split_list(const std::string& text)
+{
+    std::vector<std::string> items;
+    std::istringstream in{text};
+    for (std::string item; std::getline(in, item, ',');) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+bool contains(const std::vector<std::string>& names, const std::string& name)
+{
+    return std::any_of(names.begin(), names.end(), [&name](const std::string& other) {
+        return normalize_name(other) == normalize_name(name);
+    });
+}
+
+template<typename... Ts>
+std::vector<std::string> type_names(TypeList<Ts...>)
+{
+    return {ElementTraits<Ts>::name...};
+}
+
+const RegisteredSort* find_sort(const std::string& name)
+{
+    for (const auto& sort : sort_registry()) {
+        if (normalize_name(sort.name) == normalize_name(name)) {
+            return &sort;
+        }
+    }
+    throw std::invalid_argument("Unknown algorithm " + name + ", see --list.");
+}
+
+/* Parses the command line on top of the BENCHMARK_* environment variables. Throws
+ * std::invalid_argument on anything it does not understand. */
+DriverOptions parse_options(int argc, char* argv[])
+{
+    DriverOptions options;
+    options.config = BenchmarkConfig::from_environment();
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--list") {
+            options.list = true;
+            continue;
+        }
+        const std::vector<std::string> takes_value{"--algorithms", "--types", "--distributions", "--min", "--max",
+                                                   "--step", "--threads", "--json", "--csv"};
+        if (std::find(takes_value.begin(), takes_value.end(), option) == takes_value.end()) {
+            throw std::invalid_argument("Unknown option " + option + ".");
+        }
+        if (i + 1 == argc) {
+            throw std::invalid_argument("Missing value for " + option + ".");
+        }
+        std::string value = argv[++i];
+        if (option == "--algorithms") {
+            options.algorithms = split_list(value);
+        } else if (option == "--types") {
+            options.types = value == "all" ? type_names(ElementTypes{}) : split_list(value);
+        } else if (option == "--distributions") {
+            options.distributions = split_list(value);
+        } else if (option == "--min") {
+            options.min = parse_number<int>("--min", value);
+        } else if (option == "--max") {
+            options.max = parse_number<int>("--max", value);
+        } else if (option == "--step") {
+            options.step = parse_number<int>("--step", value);
+        } else if (option == "--threads") {
+            options.threads.clear();
+            for (const auto& count : split_list(value)) {
+                options.threads.push_back(parse_number<int>("--threads", count));
+            }
+        } else if (option == "--json") {
+            options.config.json_path = value;
+        } else {
+            options.config.csv_path = value;
+        }
+    }
+
+    if (options.min < 1 || options.max < options.min || options.step < 2) {
+        throw std::invalid_argument("Sizes need 1 <= min <= max and a step of at least 2.");
+    }
+    if (options.threads.empty() || *std::min_element(options.threads.begin(), options.threads.end()) < 1) {
+        throw std::invalid_argument("Thread counts must be positive.");
+    }
+    for (const auto& type : options.types) {
+        if (!contains(type_names(ElementTypes{}), type)) {
+            throw std::invalid_argument("Unknown element type " + type + ".");
+        }
+    }
+    for (const auto& distribution : options.distributions) {
+        const auto& known = bork_lib::distributions();
+        if (std::none_of(known.begin(), known.end(), [&distribution](const auto& d) {
+                return normalize_name(d.first) == normalize_name(distribution);
+            })) {
+            throw std::invalid_argument("Unknown distribution " + distribution + ".");
+        }
+    }
+    return options;
+}
+
+/* One column of a table: an algorithm, at one thread count if it is parallel. */
+struct Variant
+{
+    const RegisteredSort* sort;
+    int threads;
+    std::string label;
+    bool active = true;      // false once the next size is expected to exceed the time limit
+    double previous = 0.0;
+};
+
+/* Thread pools are created on first use and kept for the whole run, so that starting the
+ * workers is never timed. main starts them all before pinning, so that BENCHMARK_CPU pins
+ * only the timing thread and the workers keep every CPU. */
+ThreadPool& pool_for(int threads)
+{
+    static std::map<int, std::unique_ptr<ThreadPool>> pools;
+    auto& pool = pools[threads];
+    if (!pool) {
+        pool = std::make_unique<ThreadPool>(static_cast<std::size_t>(threads));
+    }
+    return *pool;
+}
+
+/* Runs the selected algorithms that support element type T on every selected distribution,
+ * printing a table per distribution with a row per size: the median time of each algorithm
+ * and its speedup over the first one. */
+template<typename T>
+void run_type(const DriverOptions& options, const std::vector<const RegisteredSort*>& sorts)
+{
+    std::vector<Variant> variants;
+    for (auto sort : sorts) {
+        if (!sort->function<T>()) {
+            continue;
+        }
+        if (sort->parallel) {
+            for (auto threads : options.threads) {
+                variants.push_back({sort, threads, sort->name + "/" + std::to_string(threads)});
+            }
+        } else {
+            variants.push_back({sort, 1, sort->name});
+        }
+    }
+    if (variants.empty()) {
+        return;
+    }
+
+    for (const auto& distribution : distributions()) {
+        if (!options.distributions.empty() && !contains(options.distributions, distribution.first)) {
+            continue;
+        }
+        for (auto& variant : variants) {
+            variant.active = true;
+            variant.previous = 0.0;
+        }
+
+        std::cout << '\n' << distribution.first << ", " << ElementTraits<T>::name << " (median seconds";
+        std::cout << (variants.size() > 1 ? ", speedup over " + variants.front().label + "):\n" : "):\n");
+        std::cout << std::setw(12) << "size";
+        for (const auto& variant : variants) {
+            std::cout << std::setw(static_cast<int>(std::max<std::size_t>(variant.label.size(), 18) + 2))
+                      << variant.label;
+        }
+        std::cout << '\n';
+
+        std::default_random_engine re {};
+        std::vector<BenchmarkResult> results;
+        std::vector<std::string> failures;
+        for (auto i = options.min; static_cast<std::size_t>(i) * sizeof(T) <= benchmark_max_bytes;
+             i *= options.step) {
+            if (std::none_of(variants.begin(), variants.end(), [i](const Variant& v) {
+                    return v.active && i <= v.sort->max_size;
+                })) {
+                break;
+            }
+
+            auto input = make_elements<T>(distribution.second(i, re));
+            std::cout << std::setw(12) << i;
+            double baseline = 0.0;
+            for (std::size_t j = 0; j < variants.size(); ++j) {
+                auto& variant = variants[j];
+                auto width = static_cast<int>(std::max<std::size_t>(variant.label.size(), 18) + 2);
+                if (!variant.active || i > variant.sort->max_size) {
+                    std::cout << std::setw(width) << "-";
+                    continue;
+                }
+
+                auto& pool = pool_for(variant.threads);
+                const auto& func = variant.sort->function<T>();
+                SortFunction<T> sort = [&func, &pool](auto low, auto high) { func(low, high, pool); };
+                // the counters only see the calling thread, so parallel sorts go without them
+                auto config = options.config;
+                config.counters = config.counters && !variant.sort->parallel;
+                BenchmarkResult result;
+                try {
+                    result = measure(variant.sort->name, distribution.first, sort, input, config);
+                } catch (const std::exception& e) {
+                    // report the failure and keep the rest of the sweep going without this variant
+                    result.algorithm = variant.sort->name;
+                    result.element_type = ElementTraits<T>::name;
+                    result.distribution = distribution.first;
+                    result.size = i;
+                    result.error = e.what();
+                    failures.push_back(variant.label + " failed at " + std::to_string(i) + " elements: " + e.what());
+                }
+                result.threads = variant.threads;
+                results.push_back(result);
+                if (!result.error.empty()) {
+                    std::cout << std::setw(width) << "failed" << std::flush;
+                    variant.active = false;
+                    continue;
+                }
+
+                std::ostringstream cell;
+                cell << std::setprecision(3) << result.median;
+                if (j == 0) {
+                    baseline = result.median;
+                } else if (baseline > 0.0) {
+                    cell << " (" << std::fixed << std::setprecision(2) << baseline / result.median << "x)";
+                }
+                std::cout << std::setw(width) << cell.str() << std::flush;
+
+                variant.active = within_time_limit(variant.previous, result.median);
+                variant.previous = result.median;
+            }
+            std::cout << '\n';
+            for (const auto& failure : failures) {
+                std::cerr << failure << '\n';
+            }
+            failures.clear();
+            if (i > options.max / options.step) {   // the next size is past max, and may not fit an int
+                break;
+            }
+        }
+        record_results(results, options.config);
+    }
+}
+
+template<typename... Ts>
+void run_types(const DriverOptions& options, const std::vector<const RegisteredSort*>& sorts, TypeList<Ts...>)
+{
+    ((contains(options.types, ElementTraits<Ts>::name) ? run_type<Ts>(options, sorts) : void()), ...);
+}
+
+template<typename... Ts>
+std::string supported_types(const RegisteredSort& sort, TypeList<Ts...>)
+{
+    std::string names;
+    ((names += sort.function<Ts>() ? std::string{names.empty() ? "" : ", "} + ElementTraits<Ts>::name : ""), ...);
+    return names;
+}
+
+int main(int argc, char* argv[])
+{
+    DriverOptions options;
+    std::vector<const RegisteredSort*> sorts;
+    try {
+        options = parse_options(argc, argv);
+        for (const auto& name : options.algorithms) {
+            sorts.push_back(find_sort(name));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n' << usage;
+        return 1;
+    }
+
+    if (sorts.empty()) {
+        for (const auto& sort : sort_registry()) {
+            sorts.push_back(&sort);
+        }
+        std::sort(sorts.begin(), sorts.end(), [](auto a, auto b) { return a->name < b->name; });
+    }
+    if (options.list) {
+        for (auto sort : sorts) {
+            std::cout << sort->name << (sort->parallel ? " (parallel)" : "") << ": "
+                      << supported_types(*sort, ElementTypes{}) << '\n';
+        }
+        return 0;
+    }
+
+    auto any_parallel = std::any_of(sorts.begin(), sorts.end(), [](auto sort) { return sort->parallel; });
+    if (any_parallel) {
+        for (auto threads : options.threads) {
+            pool_for(threads);
+        }
+    }
+    apply_affinity(options.config);
+    if (options.config.counters && any_parallel) {
+        std::cerr << "Hardware counters count only the calling thread, so they are left blank for parallel sorts.\n";
+    }
+    run_types(options, sorts, ElementTypes{});
+}
\ No newline at end of file
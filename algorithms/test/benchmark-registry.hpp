@@ -0,0 +1,89 @@
+#ifndef BENCHMARK_REGISTRY_HPP
+#define BENCHMARK_REGISTRY_HPP
+
+#include <functional>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "benchmark.hpp"
+#include "../src/thread-pool.hpp"
+
+namespace bork_lib
+{
+
+/* The registry of the sorts that the benchmark driver runs. Every *-benchmark.cpp file
+ * registers its algorithms with a static SortRegistrar, so an algorithm joins the driver
+ * by adding its file to the benchmark executable. */
+
+template<typename T>
+using PoolSortFunction = std::function<void(typename std::vector<T>::iterator, typename std::vector<T>::iterator,
+                                            ThreadPool&)>;
+
+template<typename List>
+struct PoolSortFunctions;
+
+template<typename... Ts>
+struct PoolSortFunctions<TypeList<Ts...>>
+{
+    using type = std::tuple<PoolSortFunction<Ts>...>;
+};
+
+struct RegisteredSort
+{
+    std::string name;
+    bool parallel = false;   // takes a thread pool, and is run once for every thread count
+    int max_size = std::numeric_limits<int>::max();
+    PoolSortFunctions<ElementTypes>::type functions;   // empty for the types it does not support
+
+    template<typename T>
+    const PoolSortFunction<T>& function() const { return std::get<PoolSortFunction<T>>(functions); }
+};
+
+inline std::vector<RegisteredSort>& sort_registry()
+{
+    static std::vector<RegisteredSort> registry;
+    return registry;
+}
+
+/* Registers a sort under a name. The sort is a generic callable that is instantiated for
+ * each of the given element types: either sort(low, high), or sort(low, high, pool) for a
+ * parallel sort. Inputs larger than max_size are skipped, which keeps quadratic sorts short. */
+class SortRegistrar
+{
+public:
+    template<typename Sort, typename... Ts>
+    SortRegistrar(std::string name, Sort sort, TypeList<Ts...>, int max_size = std::numeric_limits<int>::max());
+
+    template<typename Sort>
+    SortRegistrar(std::string name, Sort sort, int max_size = std::numeric_limits<int>::max())
+      : SortRegistrar(std::move(name), std::move(sort), ElementTypes{}, max_size) {}
+};
+
+template<typename Sort, typename... Ts>
+SortRegistrar::SortRegistrar(std::string name, Sort sort, TypeList<Ts...>, int max_size)
+{
+    RegisteredSort entry;
+    entry.name = std::move(name);
+    entry.max_size = max_size;
+    auto add = [&entry, &sort](auto* type) {
+        using T = std::remove_pointer_t<decltype(type)>;
+        using Iter = typename std::vector<T>::iterator;
+        if constexpr (std::is_invocable_v<Sort&, Iter, Iter, ThreadPool&>) {
+            entry.parallel = true;
+            std::get<PoolSortFunction<T>>(entry.functions) = sort;
+        } else {
+            std::get<PoolSortFunction<T>>(entry.functions) = [sort](Iter low, Iter high, ThreadPool&) {
+                sort(low, high);
+            };
+        }
+    };
+    (add(static_cast<Ts*>(nullptr)), ...);
+    sort_registry().push_back(std::move(entry));
+}
+
+} // end namespace
+
+#endif
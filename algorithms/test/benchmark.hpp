@@ -1,44 +1,849 @@
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <numeric>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace bork_lib
 {
 
 using iter_type = std::vector<int>::iterator;
 
-void benchmark(const std::function<void(iter_type, iter_type)>& func, int min, int max, int step)
+inline std::vector<int> random_vector(int size, std::default_random_engine& re)
 {
-    std::default_random_engine re {};
-    std::map<int, double> times;
+    std::uniform_int_distribution<> dist{-size, size};
+    std::vector<int> vec;
+    vec.reserve(static_cast<std::size_t>(size));
+    for (int j = 0; j < size; ++j) {
+        vec.push_back(dist(re));
+    }
+
+    return vec;
+}
+
+inline std::vector<int> sorted_vector(int size, std::default_random_engine& re)
+{
+    auto vec = random_vector(size, re);
+    std::sort(vec.begin(), vec.end());
+    return vec;
+}
+
+inline std::vector<int> reversed_vector(int size, std::default_random_engine& re)
+{
+    auto vec = sorted_vector(size, re);
+    std::reverse(vec.begin(), vec.end());
+    return vec;
+}
+
+/* Ascends to the middle and descends from there. */
+inline std::vector<int> organ_pipe_vector(int size, std::default_random_engine&)
+{
+    std::vector<int> vec;
+    vec.reserve(static_cast<std::size_t>(size));
+    for (int j = 0; j < size; ++j) {
+        vec.push_back(std::min(j, size - 1 - j));
+    }
+
+    return vec;
+}
+
+/* Sixteen ascending runs of equal length. */
+inline std::vector<int> sawtooth_vector(int size, std::default_random_engine&)
+{
+    auto period = size / 16 + 1;
+    std::vector<int> vec;
+    vec.reserve(static_cast<std::size_t>(size));
+    for (int j = 0; j < size; ++j) {
+        vec.push_back(j % period);
+    }
+
+    return vec;
+}
+
+/* Sixteen distinct values in random order. */
+inline std::vector<int> few_unique_vector(int size, std::default_random_engine& re)
+{
+    std::uniform_int_distribution<> dist{0, 15};
+    std::vector<int> vec;
+    vec.reserve(static_cast<std::size_t>(size));
+    for (int j = 0; j < size; ++j) {
+        vec.push_back(dist(re));
+    }
+
+    return vec;
+}
+
+/* Values drawn from 1 to size with probability roughly proportional to 1 / value, using the
+ * continuous inverse of the Zipf distribution with exponent 1, so a handful of values make
+ * up most of the input. */
+inline std::vector<int> zipf_vector(int size, std::default_random_engine& re)
+{
+    std::uniform_real_distribution<> dist{0.0, 1.0};
+    auto log_size = std::log(size + 1.0);
+    std::vector<int> vec;
+    vec.reserve(static_cast<std::size_t>(size));
+    for (int j = 0; j < size; ++j) {
+        vec.push_back(static_cast<int>(std::exp(dist(re) * log_size)));
+    }
+
+    return vec;
+}
+
+/* Sorted input in which swaps random pairs have been exchanged. */
+inline std::vector<int> nearly_sorted_vector(int size, std::default_random_engine& re, int swaps)
+{
+    auto vec = sorted_vector(size, re);
+    std::uniform_int_distribution<std::size_t> dist{0, vec.size() - 1};
+    for (int j = 0; j < swaps && !vec.empty(); ++j) {
+        std::swap(vec[dist(re)], vec[dist(re)]);
+    }
+
+    return vec;
+}
+
+inline std::vector<int> all_equal_vector(int size, std::default_random_engine&)
+{
+    return std::vector<int>(static_cast<std::size_t>(size), 42);
+}
+
+using Generator = std::function<std::vector<int>(int, std::default_random_engine&)>;
+
+/* The input distributions that every benchmark runs against. Add a generator here and all
+ * benchmarks pick it up. */
+inline const std::vector<std::pair<std::string, Generator>>& distributions()
+{
+    static const std::vector<std::pair<std::string, Generator>> generators = {
+        {"random", random_vector},
+        {"sorted", sorted_vector},
+        {"reversed", reversed_vector},
+        {"organ pipe", organ_pipe_vector},
+        {"sawtooth", sawtooth_vector},
+        {"few unique", few_unique_vector},
+        {"zipf", zipf_vector},
+        {"nearly sorted", [](int size, std::default_random_engine& re) {
+            return nearly_sorted_vector(size, re, size / 100 + 1);
+        }},
+        {"all equal", all_equal_vector},
+    };
+    return generators;
+}
+
+/* Element types. The generators produce int keys with the shape of the distribution, and
+ * ElementTraits turns every key into an element of another type with the same relative
+ * order, so each distribution keeps its shape across types. */
+
+/* A trivially copyable record of the given size that is sorted by its key. */
+template<std::size_t Bytes>
+struct Record
+{
+    static_assert(Bytes > sizeof(std::int64_t), "records need room for a payload");
+
+    std::int64_t key;
+    std::array<char, Bytes - sizeof(std::int64_t)> payload;
+
+    friend bool operator<(const Record& a, const Record& b) { return a.key < b.key; }
+};
+
+template<typename T>
+struct ElementTraits;
+
+template<>
+struct ElementTraits<int>
+{
+    static constexpr const char* name = "int";
+    static int make(int key) { return key; }
+};
+
+template<>
+struct ElementTraits<double>
+{
+    static constexpr const char* name = "double";
+    static double make(int key) { return key + 0.5; }
+};
+
+template<>
+struct ElementTraits<std::uint64_t>
+{
+    static constexpr const char* name = "uint64";
+    static std::uint64_t make(int key)   // flips the sign bit, so negative keys stay below the rest
+    {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(key)) ^ (std::uint64_t{1} << 63);
+    }
+};
+
+/* URL-like strings with long shared prefixes: the top two bits of the key pick one of four
+ * hosts and the rest are spelled in base 26 by the first seven letters of the path, so byte
+ * order matches key order. The path then goes on for a length picked by the key, which only
+ * equal keys share. */
+template<>
+struct ElementTraits<std::string>
+{
+    static constexpr const char* name = "string";
+    static std::string make(int key)
+    {
+        static const std::array<const char*, 4> hosts = {
+            "http://cdn.example.net/static/images/", "https://shop.example.com/products/",
+            "https://www.example.com/", "https://www.example.org/wiki/"
+        };
+        auto bits = static_cast<std::uint32_t>(key) ^ 0x80000000u;
+        std::string url = hosts[bits >> 30];
+        std::string path(7, 'a');
+        auto rest = bits & 0x3fffffffu;
+        for (auto i = path.size(); i-- > 0; rest /= 26) {
+            path[i] = static_cast<char>('a' + rest % 26);
+        }
+        url += path;
+        auto hash = bits * 2654435761u;
+        for (auto length = hash >> 27; length > 0; --length) {
+            hash = hash * 1103515245u + 12345u;
+            url += static_cast<char>('a' + (hash >> 16) % 26);
+        }
+        return url;
+    }
+};
+
+template<std::size_t Bytes>
+struct ElementTraits<Record<Bytes>>
+{
+    static constexpr const char* name = Bytes == 16 ? "record16" : Bytes == 64 ? "record64" : "record256";
+    static Record<Bytes> make(int key)
+    {
+        Record<Bytes> record{key, {}};
+        record.payload.fill(static_cast<char>(key));
+        return record;
+    }
+};
+
+template<typename... Ts>
+struct TypeList {};
+
+/* The element types that benchmark_types covers. */
+using ElementTypes = TypeList<int, double, std::uint64_t, std::string, Record<16>, Record<64>, Record<256>>;
+
+template<typename T>
+std::vector<T> make_elements(const std::vector<int>& keys)
+{
+    std::vector<T> elements;
+    elements.reserve(keys.size());
+    for (auto key : keys) {
+        elements.push_back(ElementTraits<T>::make(key));
+    }
+    return elements;
+}
+
+/* Inputs larger than this many bytes are skipped, which caps the sizes of the wide types. */
+constexpr std::size_t benchmark_max_bytes = std::size_t{1} << 31;
+
+constexpr double benchmark_time_limit = 60.0;
+
+/* Returns whether the next input size is expected to sort within benchmark_time_limit,
+ * assuming the time grows by the same factor as it did from the previous size. Larger inputs
+ * from a distribution are skipped once it is not, so that quadratic worst cases show up
+ * without stalling the benchmark. */
+inline bool within_time_limit(double previous, double current)
+{
+    return previous <= 0.0 || current * (current / previous) <= benchmark_time_limit;
+}
+
+/* How every measurement is taken. Each field can be overridden by the environment variable
+ * named next to it, so the benchmark executables need no arguments. */
+struct BenchmarkConfig
+{
+    int warmup = 1;                 // BENCHMARK_WARMUP: untimed runs before the first sample
+    int min_repetitions = 5;        // BENCHMARK_MIN_REPETITIONS
+    int max_repetitions = 30;       // BENCHMARK_MAX_REPETITIONS
+    double time_budget = 2.0;       // BENCHMARK_TIME_BUDGET: seconds after which sampling stops once
+                                    // min_repetitions samples are taken
+    int cpu = -1;                   // BENCHMARK_CPU: pins the timing thread to this CPU if not negative
+    bool counters = false;          // BENCHMARK_COUNTERS: reads hardware counters around every sample
+    std::string json_path;          // BENCHMARK_JSON: writes all results as JSON
+    std::string csv_path;           // BENCHMARK_CSV: writes all results as CSV
+
+    static BenchmarkConfig from_environment();
+};
+
+/* Returns the value of a BENCHMARK_* variable or a command-line option as a number. Throws
+ * std::invalid_argument naming the variable or option if the value is not one. */
+template<typename Number>
+Number parse_number(const char* name, const std::string& value)
+{
+    std::size_t end = 0;
+    Number number{};
+    try {
+        if constexpr (std::is_floating_point_v<Number>) {
+            number = std::stod(value, &end);
+        } else {
+            number = std::stoi(value, &end);
+        }
+    } catch (const std::exception&) {
+        end = 0;
+    }
+    if (end == 0 || end != value.size()) {
+        throw std::invalid_argument(std::string{name} + " must be a number, not \"" + value + "\".");
+    }
+    return number;
+}
+
+/* Reads the config from the environment. There is always at least one sample. */
+inline BenchmarkConfig BenchmarkConfig::from_environment()
+{
+    BenchmarkConfig config;
+    if (auto value = std::getenv("BENCHMARK_WARMUP")) {
+        config.warmup = parse_number<int>("BENCHMARK_WARMUP", value);
+    }
+    if (auto value = std::getenv("BENCHMARK_MIN_REPETITIONS")) {
+        config.min_repetitions = parse_number<int>("BENCHMARK_MIN_REPETITIONS", value);
+    }
+    if (auto value = std::getenv("BENCHMARK_MAX_REPETITIONS")) {
+        config.max_repetitions = parse_number<int>("BENCHMARK_MAX_REPETITIONS", value);
+    }
+    if (auto value = std::getenv("BENCHMARK_TIME_BUDGET")) {
+        config.time_budget = parse_number<double>("BENCHMARK_TIME_BUDGET", value);
+    }
+    if (auto value = std::getenv("BENCHMARK_CPU")) {
+        config.cpu = parse_number<int>("BENCHMARK_CPU", value);
+    }
+    if (auto value = std::getenv("BENCHMARK_COUNTERS")) {
+        config.counters = parse_number<int>("BENCHMARK_COUNTERS", value) != 0;
+    }
+    if (auto value = std::getenv("BENCHMARK_JSON")) {
+        config.json_path = value;
+    }
+    if (auto value = std::getenv("BENCHMARK_CSV")) {
+        config.csv_path = value;
+    }
+    config.min_repetitions = std::max(config.min_repetitions, 1);
+    config.max_repetitions = std::max(config.max_repetitions, config.min_repetitions);
+    return config;
+}
+
+/* The summary of the samples of one algorithm on one input. */
+struct BenchmarkResult
+{
+    std::string algorithm;
+    std::string element_type;
+    std::string distribution;
+    int threads = 1;
+    std::string affinity;   // the CPUs the timing thread may run on, such as "0-3,6"
+    int size = 0;
+    int repetitions = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    std::vector<std::pair<std::string, double>> counters;   // per element, for the counters that could be read
+    std::string error;   // why the sort failed, in which case there are no statistics
+
+    double elements_per_second() const { return median > 0.0 ? size / median : 0.0; }
+};
+
+/* Fills in the statistics of a result from its samples, in seconds. The percentiles use
+ * the nearest rank and the standard deviation is the sample standard deviation. */
+inline void summarize(BenchmarkResult& result, std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    auto n = samples.size();
+    auto rank = [&samples, n](double p) {
+        auto index = static_cast<std::size_t>(std::ceil(p * static_cast<double>(n)));
+        return samples[std::min(std::max<std::size_t>(index, 1), n) - 1];
+    };
+    result.repetitions = static_cast<int>(n);
+    result.min = samples.front();
+    result.median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    result.p95 = rank(0.95);
+    result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(n);
+    double squares = 0.0;
+    for (auto sample : samples) {
+        squares += (sample - result.mean) * (sample - result.mean);
+    }
+    result.stddev = n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.0;
+}
+
+/* Pins the calling thread to one CPU, so that samples are not spread over cores with
+ * different caches and clocks. Threads it starts afterwards inherit the pin, so thread pools
+ * have to be started before. Returns false where that is unsupported or not permitted. */
+inline bool pin_to_cpu(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+/* Returns the CPUs the calling thread may run on as a list of ranges, such as "0-3,6", or
+ * an empty string where that is unknown. */
+inline std::string affinity_list()
+{
+    std::string list;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return list;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &set)) {
+            continue;
+        }
+        auto last = cpu;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set)) {
+            ++last;
+        }
+        list += (list.empty() ? "" : ",") + std::to_string(cpu) + (last > cpu ? "-" + std::to_string(last) : "");
+        cpu = last;
+    }
+#endif
+    return list;
+}
+
+/* Hardware performance counters read with perf_event_open around the timed region, counting
+ * user-space events of the calling thread only: work handed to a thread pool is not seen, so
+ * the benchmark driver leaves the counters of parallel sorts blank rather than under-report
+ * them. Counters the kernel refuses (perf_event_paranoid, no PMU in a virtual machine,
+ * another OS) are left out, and when none can be opened the benchmarks fall back to wall
+ * time alone. */
+constexpr std::array<const char*, 6> counter_names = {
+    "cycles", "instructions", "branch-misses", "L1D-misses", "LLC-misses", "dTLB-misses"
+};
+
+class PerfCounters
+{
+private:
+    std::array<int, counter_names.size()> fds;
+    std::array<double, counter_names.size()> totals{};
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    bool available() const;
+    void start();
+    void stop();
+    std::vector<std::pair<std::string, double>> per_element(double elements) const;
+};
 
-    for(auto i = min; i <= max; i *= step) {
-        std::uniform_int_distribution<> dist{-i, i};
-        std::vector<int> vec;
-        vec.reserve(static_cast<std::size_t>(i));
-        for (int j = 0; j < i; ++j) {
-            vec.push_back(dist(re));
+inline PerfCounters::PerfCounters()
+{
+    fds.fill(-1);
+#ifdef __linux__
+    auto cache_miss = [](std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    };
+    const std::array<std::pair<std::uint32_t, std::uint64_t>, counter_names.size()> events = {{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+        {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB)},
+    }};
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].first;
+        attr.config = events[i].second;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+}
+
+inline PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (auto fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+inline bool PerfCounters::available() const
+{
+    return std::any_of(fds.begin(), fds.end(), [](int fd) { return fd >= 0; });
+}
+
+inline void PerfCounters::start()
+{
+#ifdef __linux__
+    for (auto fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/* Adds the counts since start() to the totals, scaled up for the time a counter was not
+ * scheduled when there are more counters than the PMU can run at once. */
+inline void PerfCounters::stop()
+{
+#ifdef __linux__
+    for (auto fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+        std::uint64_t values[3];   // value, time enabled, time running
+        if (fds[i] >= 0 && read(fds[i], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) &&
+            values[2] > 0) {
+            totals[i] += static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+        }
+    }
+#endif
+}
+
+inline std::vector<std::pair<std::string, double>> PerfCounters::per_element(double elements) const
+{
+    std::vector<std::pair<std::string, double>> values;
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+        if (fds[i] >= 0) {
+            values.emplace_back(counter_names[i], totals[i] / elements);
+        }
+    }
+    return values;
+}
+
+template<typename T = int>
+using SortFunction = std::function<void(typename std::vector<T>::iterator, typename std::vector<T>::iterator)>;
+
+/* Tells whether a timed run left the right result, for operations other than sorting such as
+ * selection or merging. Without one the result has to be sorted. */
+template<typename T = int>
+using CheckFunction = std::function<bool(const std::vector<T>&)>;
+
+/* Runs the function on a copy of the input and returns the time taken, counting hardware
+ * events over the same region if counters are given. Throws if the copy ends up unsorted, or
+ * fails the check if there is one. */
+template<typename T>
+double time_sort(const SortFunction<T>& func, const std::vector<T>& input, PerfCounters* counters = nullptr,
+                 const CheckFunction<T>& check = {})
+{
+    auto vec = input;
+    if (counters) {
+        counters->start();
+    }
+    auto start = std::chrono::steady_clock::now();
+    func(vec.begin(), vec.end());
+    auto stop = std::chrono::steady_clock::now();
+    if (counters) {
+        counters->stop();
+    }
+
+    if (check && !check(vec)) {
+        throw std::runtime_error("Wrong result.");
+    }
+    if (!check && !std::is_sorted(vec.begin(), vec.end())) {
+        throw std::runtime_error("Vector not properly sorted.");
+    }
+    std::chrono::duration<double> time = stop - start;
+    return time.count();
+}
+
+/* Sorts the input config.warmup times untimed, then samples it until max_repetitions
+ * samples are taken or the time budget is spent with at least min_repetitions of them.
+ * Counters are averaged over all samples, and at least one sample is always taken. */
+template<typename T>
+BenchmarkResult measure(const std::string& algorithm, const std::string& distribution, const SortFunction<T>& func,
+                        const std::vector<T>& input, const BenchmarkConfig& config, const CheckFunction<T>& check = {})
+{
+    for (int i = 0; i < config.warmup; ++i) {
+        time_sort(func, input, nullptr, check);
+    }
+
+    std::unique_ptr<PerfCounters> counters;
+    if (config.counters) {
+        counters = std::make_unique<PerfCounters>();
+        static bool warned = false;
+        if (!counters->available() && !warned) {
+            std::cerr << "Hardware counters unavailable (see perf_event_paranoid), reporting wall time only.\n";
+            warned = true;
+        }
+    }
+
+    std::vector<double> samples;
+    double total = 0.0;
+    while (samples.empty() || (static_cast<int>(samples.size()) < config.max_repetitions &&
+           (static_cast<int>(samples.size()) < config.min_repetitions || total < config.time_budget))) {
+        samples.push_back(time_sort(func, input, counters.get(), check));
+        total += samples.back();
+    }
+
+    BenchmarkResult result;
+    result.algorithm = algorithm;
+    result.element_type = ElementTraits<T>::name;
+    result.distribution = distribution;
+    result.affinity = affinity_list();
+    result.size = static_cast<int>(input.size());
+    if (counters && !input.empty()) {
+        result.counters = counters->per_element(static_cast<double>(samples.size() * input.size()));
+    }
+    summarize(result, std::move(samples));
+    return result;
+}
+
+/* Returns every result measured by this process so far. */
+inline std::vector<BenchmarkResult>& recorded_results()
+{
+    static std::vector<BenchmarkResult> results;
+    return results;
+}
+
+/* Returns the string as a JSON string literal. */
+inline std::string json_quote(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (auto c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/* Returns the text as a CSV field, quoted when it holds a separator or a quote. */
+inline std::string csv_field(const std::string& text)
+{
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (auto c : text) {
+        quoted += c == '"' ? std::string{"\"\""} : std::string{c};
+    }
+    return quoted + "\"";
+}
+
+inline void write_json(std::ostream& out, const std::vector<BenchmarkResult>& results)
+{
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"algorithm\": " << json_quote(r.algorithm) << ", \"element_type\": " << json_quote(r.element_type)
+            << ", \"distribution\": " << json_quote(r.distribution) << ", \"threads\": " << r.threads
+            << ", \"affinity\": " << json_quote(r.affinity) << ", \"size\": " << r.size << ", \"repetitions\": " << r.repetitions << ", \"min\": " << r.min
+            << ", \"median\": " << r.median << ", \"p95\": " << r.p95 << ", \"mean\": " << r.mean
+            << ", \"stddev\": " << r.stddev << ", \"elements_per_second\": " << r.elements_per_second();
+        if (!r.counters.empty()) {
+            out << ", \"counters_per_element\": {";
+            for (std::size_t j = 0; j < r.counters.size(); ++j) {
+                out << (j > 0 ? ", " : "") << json_quote(r.counters[j].first) << ": " << r.counters[j].second;
+            }
+            out << "}";
+        }
+        if (!r.error.empty()) {
+            out << ", \"error\": " << json_quote(r.error);
         }
+        out << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
 
-        auto start = std::chrono::high_resolution_clock::now();
-        func(vec.begin(), vec.end());
-        auto stop = std::chrono::high_resolution_clock::now();
+inline void write_csv(std::ostream& out, const std::vector<BenchmarkResult>& results)
+{
+    out << "algorithm,element_type,distribution,threads,affinity,size,repetitions,min,median,p95,mean,stddev,"
+           "elements_per_second";
+    for (auto name : counter_names) {
+        out << ',' << name << "_per_element";
+    }
+    out << ",error\n";
+    for (const auto& r : results) {
+        out << r.algorithm << ',' << r.element_type << ',' << r.distribution << ',' << r.threads << ','
+            << csv_field(r.affinity) << ',' << r.size << ',' << r.repetitions << ',' << r.min << ',' << r.median << ',' << r.p95 << ',' << r.mean << ',' << r.stddev << ','
+            << r.elements_per_second();
+        for (auto name : counter_names) {   // empty where the counter could not be read
+            out << ',';
+            for (const auto& counter : r.counters) {
+                if (counter.first == name) {
+                    out << counter.second;
+                }
+            }
+        }
+        out << ',' << csv_field(r.error) << '\n';
+    }
+}
 
-        if (!std::is_sorted(vec.begin(), vec.end())) {
-            throw std::runtime_error("Vector not properly sorted.");
+/* Adds results to the recorded ones and rewrites the output files of the config with all of
+ * them, so an executable that runs several benchmarks leaves them all in one file. */
+inline void record_results(const std::vector<BenchmarkResult>& results, const BenchmarkConfig& config)
+{
+    auto& recorded = recorded_results();
+    recorded.insert(recorded.end(), results.begin(), results.end());
+    if (!config.json_path.empty()) {
+        std::ofstream out{config.json_path};
+        out.precision(9);
+        write_json(out, recorded);
+    }
+    if (!config.csv_path.empty()) {
+        std::ofstream out{config.csv_path};
+        out.precision(9);
+        write_csv(out, recorded);
+    }
+}
+
+/* Pins the calling thread as the config asks, warning once if that fails. */
+inline void apply_affinity(const BenchmarkConfig& config)
+{
+    static bool warned = false;
+    if (config.cpu >= 0 && !pin_to_cpu(config.cpu) && !warned) {
+        std::cerr << "Unable to pin to CPU " << config.cpu << ", running unpinned.\n";
+        warned = true;
+    }
+}
+
+/* Prints the counters of a result per element, if there are any. */
+inline void print_counters(const BenchmarkResult& r)
+{
+    if (r.counters.empty()) {
+        return;
+    }
+
+    std::cout << "    per element:";
+    for (std::size_t i = 0; i < r.counters.size(); ++i) {
+        std::cout << (i > 0 ? "," : "") << ' ' << r.counters[i].second << ' ' << r.counters[i].first;
+    }
+    std::cout << '\n';
+}
+
+inline void print_result(const BenchmarkResult& r)
+{
+    std::cout << r.size << " elements - " << r.median << " sec median (min " << r.min << ", p95 " << r.p95
+              << ", stddev " << r.stddev << ", " << r.repetitions << " runs), " << r.elements_per_second()
+              << " elements/sec\n";
+    print_counters(r);
+}
+
+/* Benchmarks a sort on inputs of element type T from every distribution. */
+template<typename T = int>
+void benchmark(const std::string& algorithm, const SortFunction<T>& func, int min, int max, int step,
+               const BenchmarkConfig& config = BenchmarkConfig::from_environment())
+{
+    apply_affinity(config);
+    std::vector<BenchmarkResult> results;
+    for (const auto& distribution : distributions()) {
+        std::default_random_engine re {};
+        double previous = 0.0;
+
+        std::cout << "Time to sort (" << distribution.first << ", " << ElementTraits<T>::name << "):\n";
+        for(auto i = min; i <= max && static_cast<std::size_t>(i) * sizeof(T) <= benchmark_max_bytes; i *= step) {
+            auto input = make_elements<T>(distribution.second(i, re));
+            results.push_back(measure(algorithm, distribution.first, func, input, config));
+            print_result(results.back());
+            if (!within_time_limit(previous, results.back().median)) {
+                break;
+            }
+            previous = results.back().median;
         }
-        std::chrono::duration<double> time = stop - start;
-        times[i] = time.count();
     }
+    record_results(results, config);
+}
 
-    std::cout << "Time to sort:\n";
-    for (const auto& x : times) {
-        std::cout << x.first << " elements - " << x.second << " sec\n";
+inline void benchmark(const SortFunction<>& func, int min, int max, int step)
+{
+    benchmark("sort", func, min, max, step);
+}
+
+/* Times two sorts on identical inputs of element type T and reports the speedup of the
+ * candidate's median. */
+template<typename T = int>
+void benchmark_compare(const std::string& baseline_name, const SortFunction<T>& baseline,
+                       const std::string& candidate_name, const SortFunction<T>& candidate, int min, int max, int step,
+                       const BenchmarkConfig& config = BenchmarkConfig::from_environment())
+{
+    apply_affinity(config);
+    std::vector<BenchmarkResult> results;
+    for (const auto& distribution : distributions()) {
+        std::default_random_engine re {};
+        std::pair<double, double> previous{0.0, 0.0};
+
+        std::cout << "Time to sort (" << distribution.first << ", " << ElementTraits<T>::name
+                  << ", baseline / candidate):\n";
+        for(auto i = min; i <= max && static_cast<std::size_t>(i) * sizeof(T) <= benchmark_max_bytes; i *= step) {
+            auto input = make_elements<T>(distribution.second(i, re));
+            auto first = measure(baseline_name, distribution.first, baseline, input, config);
+            auto second = measure(candidate_name, distribution.first, candidate, input, config);
+            std::cout << i << " elements - " << first.median << " sec / " << second.median << " sec median (p95 "
+                      << first.p95 << " / " << second.p95 << ", speedup " << first.median / second.median << "x)\n";
+            print_counters(first);
+            print_counters(second);
+            results.push_back(first);
+            results.push_back(second);
+            if (!within_time_limit(previous.first, first.median) || !within_time_limit(previous.second, second.median)) {
+                break;
+            }
+            previous = {first.median, second.median};
+        }
     }
+    record_results(results, config);
+}
+
+inline void benchmark_compare(const SortFunction<>& baseline, const SortFunction<>& candidate, int min, int max, int step)
+{
+    benchmark_compare("baseline", baseline, "candidate", candidate, min, max, step);
+}
+
+/* Benchmarks a sort on each of the element types. The sort is a generic callable, such as
+ * [](auto low, auto high) { heapsort(low, high); }, that is instantiated for every type. */
+template<typename Sort, typename... Ts>
+void benchmark_types(const std::string& algorithm, Sort sort, int min, int max, int step, TypeList<Ts...>)
+{
+    (benchmark<Ts>(algorithm, sort, min, max, step), ...);
+}
+
+template<typename Sort>
+void benchmark_types(const std::string& algorithm, Sort sort, int min, int max, int step)
+{
+    benchmark_types(algorithm, sort, min, max, step, ElementTypes{});
+}
+
+/* Compares two generic sorts on each of the element types. */
+template<typename Baseline, typename Candidate, typename... Ts>
+void benchmark_compare_types(const std::string& baseline_name, Baseline baseline, const std::string& candidate_name,
+                             Candidate candidate, int min, int max, int step, TypeList<Ts...>)
+{
+    (benchmark_compare<Ts>(baseline_name, baseline, candidate_name, candidate, min, max, step), ...);
+}
+
+template<typename Baseline, typename Candidate>
+void benchmark_compare_types(const std::string& baseline_name, Baseline baseline, const std::string& candidate_name,
+                             Candidate candidate, int min, int max, int step)
+{
+    benchmark_compare_types(baseline_name, baseline, candidate_name, candidate, min, max, step, ElementTypes{});
 }
 
 } // end namespace
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "benchmark-registry.hpp"
+#include "../src/block-merge-sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar block_merge_sort_benchmark{"block_merge_sort",
+    [](auto low, auto high) { block_merge_sort(low, high); }};
\ No newline at end of file
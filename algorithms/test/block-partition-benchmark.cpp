@@ -0,0 +1,8 @@
+#include "benchmark-registry.hpp"
+#include "../src/quicksort-hoare.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar block_partition_benchmark{"quicksort_hoare_block", [](auto low, auto high) {
+    quicksort_hoare<decltype(low), PartitionScheme::block>(low, high);
+}};
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "benchmark-registry.hpp"
+#include "../src/merge-sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar bottom_up_merge_sort_benchmark{"bottom_up_merge_sort",
+    [](auto low, auto high) { bottom_up_merge_sort(low, high); }};
\ No newline at end of file
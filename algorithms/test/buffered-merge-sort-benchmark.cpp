@@ -0,0 +1,7 @@
+#include "benchmark-registry.hpp"
+#include "../src/merge-sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar buffered_merge_sort_benchmark{"buffered_merge_sort",
+    [](auto low, auto high) { buffered_merge_sort(low, high); }};
\ No newline at end of file
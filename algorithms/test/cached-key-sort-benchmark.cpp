@@ -0,0 +1,17 @@
+#include <functional>
+#include <string>
+#include "benchmark-registry.hpp"
+#include "../src/cached-key-sort.hpp"
+#include "../src/introsort.hpp"
+
+using namespace bork_lib;
+
+// a deliberately expensive key that keeps the numeric order
+static int expensive_key(int x) { return std::stoi(std::to_string(x)); }
+
+static const SortRegistrar expensive_key_benchmark{"introsort_expensive_key", [](auto low, auto high) {
+    introsort(low, high, std::less<>{}, expensive_key);
+}, TypeList<int>{}};
+static const SortRegistrar cached_key_sort_benchmark{"cached_key_sort", [](auto low, auto high) {
+    cached_key_sort(low, high, std::less<>{}, expensive_key);
+}, TypeList<int>{}};
\ No newline at end of file
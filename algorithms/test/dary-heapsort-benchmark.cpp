@@ -0,0 +1,11 @@
+#include "benchmark-registry.hpp"
+#include "../src/heapsort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar bottom_up_heapsort_benchmark{"bottom_up_heapsort",
+    [](auto low, auto high) { bottom_up_heapsort(low, high); }};
+static const SortRegistrar dary_heapsort_4_benchmark{"dary_heapsort_4",
+    [](auto low, auto high) { dary_heapsort<4>(low, high); }};
+static const SortRegistrar dary_heapsort_8_benchmark{"dary_heapsort_8",
+    [](auto low, auto high) { dary_heapsort<8>(low, high); }};
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/external-sort.hpp"
+
+using namespace bork_lib;
+
+/* Usage: external-sort-benchmark [file] [size in MiB] [memory budget in MiB] */
+int main(int argc, char* argv[])
+{
+    std::string path = argc > 1 ? argv[1] : "external-sort-input.bin";
+    std::size_t size_mib = argc > 2 ? std::stoul(argv[2]) : 1024;
+    std::size_t budget_mib = argc > 3 ? std::stoul(argv[3]) : 64;
+    auto sorted_path = path + ".sorted";
+
+    std::default_random_engine re {};
+    std::uniform_int_distribution<> dist{};
+    {
+        auto file = open_file(path, "wb");
+        std::vector<int> chunk(std::size_t{1} << 18);
+        for (std::size_t written = 0; written < (size_mib << 20); written += chunk.size() * sizeof(int)) {
+            for (auto& x : chunk) {
+                x = dist(re);
+            }
+            write_records(file.get(), chunk.data(), chunk.size());
+        }
+    }
+
+    ExternalSortConfig config;
+    config.memory_budget = budget_mib << 20;
+    auto stats = external_sort<int>(path, sorted_path, config);
+
+    {
+        auto file = open_file(sorted_path, "rb");
+        std::vector<int> chunk(std::size_t{1} << 18);
+        int previous = 0;
+        bool first = true;
+        while (auto count = read_records(file.get(), chunk.data(), chunk.size())) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!first && chunk[i] < previous) {
+                    throw std::runtime_error("File not properly sorted.");
+                }
+                previous = chunk[i];
+                first = false;
+            }
+        }
+    }
+    std::remove(path.c_str());
+    std::remove(sorted_path.c_str());
+
+    std::cout << size_mib << " MiB with a " << budget_mib << " MiB budget - " << stats.runs << " runs, "
+              << stats.merge_passes << " merge passes\n"
+              << "Run formation: " << stats.run_seconds << " sec\n"
+              << "Merging: " << stats.merge_seconds << " sec\n"
+              << "I/O: " << (stats.bytes_read >> 20) << " MiB read, " << (stats.bytes_written >> 20) << " MiB written, "
+              << stats.throughput() << " MB/s\n";
+}
\ No newline at end of file
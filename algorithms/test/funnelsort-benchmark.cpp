@@ -0,0 +1,6 @@
+#include "benchmark-registry.hpp"
+#include "../src/funnelsort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar funnelsort_benchmark{"funnelsort", [](auto low, auto high) { funnelsort(low, high); }};
\ No newline at end of file
@@ -1,9 +1,6 @@
-#include "benchmark.hpp"
+#include "benchmark-registry.hpp"
 #include "../src/heapsort.hpp"
 
 using namespace bork_lib;
 
-int main()
-{
-    benchmark(heapsort<iter_type>, 1000, 100000000, 10);
-}
\ No newline at end of file
+static const SortRegistrar heapsort_benchmark{"heapsort", [](auto low, auto high) { heapsort(low, high); }};
\ No newline at end of file
@@ -1,9 +1,7 @@
-#include "benchmark.hpp"
+#include "benchmark-registry.hpp"
 #include "../src/insertion-sort.hpp"
 
 using namespace bork_lib;
 
-int main()
-{
-    benchmark(insertion_sort<iter_type>, 1000, 100000, 10);
-}
\ No newline at end of file
+static const SortRegistrar insertion_sort_benchmark{"insertion_sort",
+    [](auto low, auto high) { insertion_sort(low, high); }, 100000};
\ No newline at end of file
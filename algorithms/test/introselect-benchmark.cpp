@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "benchmark.hpp"
+#include "../src/introselect.hpp"
+
+using namespace bork_lib;
+
+/* The position of the 99th percentile that every query selects. */
+template<typename RandAccIter>
+RandAccIter percentile(RandAccIter low, RandAccIter high)
+{
+    return low + (high - low) / 100 * 99;
+}
+
+int main()
+{
+    const std::vector<std::pair<std::string, SortFunction<>>> queries = {
+        {"introsort", [](iter_type low, iter_type high) { introsort(low, high); }},
+        {"std::nth_element", [](iter_type low, iter_type high) { std::nth_element(low, percentile(low, high), high); }},
+        {"introselect", [](iter_type low, iter_type high) { introselect(low, percentile(low, high), high); }},
+        {"quickselect", [](iter_type low, iter_type high) { quickselect(low, percentile(low, high), high); }},
+    };
+
+    auto config = BenchmarkConfig::from_environment();
+    apply_affinity(config);
+    std::vector<BenchmarkResult> results;
+    for (const auto& distribution : distributions()) {
+        std::default_random_engine re {};
+        std::cout << "Time to find the 99th percentile (" << distribution.first
+                  << ", introsort / std::nth_element / introselect / quickselect):\n";
+        for (auto i = 1000; i <= 50000000; i *= i < 10000000 ? 10 : 5) {
+            auto input = distribution.second(i, re);
+            auto sorted = input;
+            std::sort(sorted.begin(), sorted.end());
+            auto expected = *percentile(sorted.begin(), sorted.end());
+            CheckFunction<> check = [expected](const std::vector<int>& vec) {
+                auto nth = percentile(vec.begin(), vec.end());
+                return *nth == expected && std::all_of(vec.begin(), nth, [nth](int x) { return x <= *nth; }) &&
+                       std::all_of(nth, vec.end(), [nth](int x) { return x >= *nth; });
+            };
+
+            std::cout << i << " elements - ";
+            for (const auto& query : queries) {
+                results.push_back(measure(query.first, distribution.first, query.second, input, config, check));
+                std::cout << (&query == &queries.front() ? "" : " / ") << results.back().median;
+            }
+            std::cout << " sec median\n";
+        }
+    }
+    record_results(results, config);
+}
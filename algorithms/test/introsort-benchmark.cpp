@@ -0,0 +1,6 @@
+#include "benchmark-registry.hpp"
+#include "../src/introsort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar introsort_benchmark{"introsort", [](auto low, auto high) { introsort(low, high); }};
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+#include "benchmark.hpp"
+#include "../src/k-way-merge.hpp"
+#include "../src/merge-sort.hpp"
+
+using namespace bork_lib;
+
+using WideRecord = Record<256>;
+using RecordIter = std::vector<WideRecord>::iterator;
+
+/* Cuts the records into shards of random lengths, sorts each of them in place and returns
+ * the offsets of their bounds. */
+std::vector<std::ptrdiff_t> make_shards(std::vector<WideRecord>& vec, int shards, std::default_random_engine& re)
+{
+    std::uniform_int_distribution<std::ptrdiff_t> dist{0, static_cast<std::ptrdiff_t>(vec.size())};
+    std::vector<std::ptrdiff_t> cuts{0, static_cast<std::ptrdiff_t>(vec.size())};
+    for (int i = 1; i < shards; ++i) {
+        cuts.push_back(dist(re));
+    }
+    std::sort(cuts.begin(), cuts.end());
+    for (std::size_t i = 0; i + 1 < cuts.size(); ++i) {
+        std::sort(vec.begin() + cuts[i], vec.begin() + cuts[i + 1]);
+    }
+    return cuts;
+}
+
+/* Merges the shards pairwise, round after round, as repeated merge() calls would. */
+void pairwise_merge(RecordIter low, const std::vector<std::ptrdiff_t>& cuts)
+{
+    std::vector<std::pair<RecordIter, RecordIter>> shards;
+    for (std::size_t i = 0; i + 1 < cuts.size(); ++i) {
+        shards.emplace_back(low + cuts[i], low + cuts[i + 1]);
+    }
+    while (shards.size() > 1) {
+        std::vector<std::pair<RecordIter, RecordIter>> merged;
+        for (std::size_t i = 0; i + 1 < shards.size(); i += 2) {
+            merge(shards[i].first, shards[i].second, shards[i + 1].second);
+            merged.emplace_back(shards[i].first, shards[i + 1].second);
+        }
+        if (shards.size() % 2 == 1) {
+            merged.push_back(shards.back());
+        }
+        shards = std::move(merged);
+    }
+}
+
+/* Times merging 256 sorted shards of every distribution. k_way_merge moves the records into
+ * a separate output, so its check looks at that. multiway_merge_sort, which sorts with it, is
+ * run by the benchmark driver. */
+int main()
+{
+    auto config = BenchmarkConfig::from_environment();
+    apply_affinity(config);
+    std::vector<BenchmarkResult> results;
+    for (const auto& distribution : distributions()) {
+        std::default_random_engine re {};
+        std::cout << "Time to merge 256 shards of 256-byte records (" << distribution.first
+                  << ", pairwise merge / k_way_merge):\n";
+        for (auto i = 1000; i <= 1000000; i *= 10) {
+            auto records = make_elements<WideRecord>(distribution.second(i, re));
+            auto cuts = make_shards(records, 256, re);
+            std::vector<WideRecord> out(records.size());
+
+            SortFunction<WideRecord> pairwise = [&cuts](RecordIter low, RecordIter) { pairwise_merge(low, cuts); };
+            SortFunction<WideRecord> k_way = [&cuts, &out](RecordIter low, RecordIter) {
+                std::vector<std::pair<std::move_iterator<RecordIter>, std::move_iterator<RecordIter>>> runs;
+                for (std::size_t j = 0; j + 1 < cuts.size(); ++j) {
+                    runs.emplace_back(std::make_move_iterator(low + cuts[j]),
+                                      std::make_move_iterator(low + cuts[j + 1]));
+                }
+                k_way_merge(runs, out.begin());
+            };
+            CheckFunction<WideRecord> check_out = [&out](const std::vector<WideRecord>&) {
+                return std::is_sorted(out.begin(), out.end());
+            };
+
+            results.push_back(measure("pairwise_merge", distribution.first, pairwise, records, config));
+            results.push_back(measure("k_way_merge", distribution.first, k_way, records, config, check_out));
+            std::cout << i << " elements - " << results[results.size() - 2].median << " sec / "
+                      << results.back().median << " sec median\n";
+        }
+    }
+    record_results(results, config);
+}
\ No newline at end of file
@@ -1,9 +1,8 @@
-#include "benchmark.hpp"
+#include "benchmark-registry.hpp"
 #include "../src/merge-sort.hpp"
 
 using namespace bork_lib;
 
-int main()
-{
-    benchmark(merge_sort<iter_type>, 1000, 100000000, 10);
-}
\ No newline at end of file
+static const SortRegistrar merge_sort_benchmark{"merge_sort", [](auto low, auto high) { merge_sort(low, high); }};
+static const SortRegistrar multiway_merge_sort_benchmark{"multiway_merge_sort",
+    [](auto low, auto high) { multiway_merge_sort(low, high); }};
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "benchmark-registry.hpp"
+#include "../src/parallel-merge-sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar parallel_merge_sort_benchmark{"parallel_merge_sort",
+    [](auto low, auto high, ThreadPool& pool) { parallel_merge_sort(low, high, pool); }};
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "benchmark-registry.hpp"
+#include "../src/parallel-quicksort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar parallel_quicksort_benchmark{"parallel_quicksort",
+    [](auto low, auto high, ThreadPool& pool) { parallel_quicksort(low, high, pool); }};
\ No newline at end of file
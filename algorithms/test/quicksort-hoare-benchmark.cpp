@@ -1,9 +1,7 @@
-#include "benchmark.hpp"
+#include "benchmark-registry.hpp"
 #include "../src/quicksort-hoare.hpp"
 
 using namespace bork_lib;
 
-int main()
-{
-    benchmark(quicksort_hoare<iter_type>, 1000, 100000000, 10);
-}
\ No newline at end of file
+static const SortRegistrar quicksort_hoare_benchmark{"quicksort_hoare",
+    [](auto low, auto high) { quicksort_hoare(low, high); }};
\ No newline at end of file
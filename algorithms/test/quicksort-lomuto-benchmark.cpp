@@ -1,9 +1,7 @@
-#include "benchmark.hpp"
+#include "benchmark-registry.hpp"
 #include "../src/quicksort-lomuto.hpp"
 
 using namespace bork_lib;
 
-int main()
-{
-    benchmark(quicksort_lomuto<iter_type>, 1000, 100000000, 10);
-}
\ No newline at end of file
+static const SortRegistrar quicksort_lomuto_benchmark{"quicksort_lomuto",
+    [](auto low, auto high) { quicksort_lomuto(low, high); }};
\ No newline at end of file
@@ -1,9 +1,7 @@
-#include "benchmark.hpp"
+#include "benchmark-registry.hpp"
 #include "../src/quicksort-random.hpp"
 
 using namespace bork_lib;
 
-int main()
-{
-    benchmark(quicksort_random<iter_type>, 1000, 100000000, 10);
-}
\ No newline at end of file
+static const SortRegistrar quicksort_random_benchmark{"quicksort_random",
+    [](auto low, auto high) { quicksort_random(low, high); }};
\ No newline at end of file
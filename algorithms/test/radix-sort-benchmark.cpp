@@ -0,0 +1,12 @@
+#include <cstdint>
+#include "benchmark-registry.hpp"
+#include "../src/radix-sort.hpp"
+
+using namespace bork_lib;
+
+using RadixTypes = TypeList<int, double, std::uint64_t>;
+
+static const SortRegistrar radix_sort_lsd_benchmark{"radix_sort_lsd",
+    [](auto low, auto high) { radix_sort_lsd(low, high); }, RadixTypes{}};
+static const SortRegistrar radix_sort_msd_benchmark{"radix_sort_msd",
+    [](auto low, auto high) { radix_sort_msd(low, high); }, RadixTypes{}};
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "benchmark-registry.hpp"
+#include "../src/sample-sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar sample_sort_benchmark{"sample_sort",
+    [](auto low, auto high, ThreadPool& pool) { sample_sort(low, high, pool); }};
\ No newline at end of file
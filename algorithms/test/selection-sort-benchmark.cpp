@@ -1,9 +1,7 @@
-#include "benchmark.hpp"
+#include "benchmark-registry.hpp"
 #include "../src/selection-sort.hpp"
 
 using namespace bork_lib;
 
-int main()
-{
-    benchmark(selection_sort<iter_type>, 1000, 100000, 10);
-}
\ No newline at end of file
+static const SortRegistrar selection_sort_benchmark{"selection_sort",
+    [](auto low, auto high) { selection_sort(low, high); }, 100000};
\ No newline at end of file
@@ -0,0 +1,6 @@
+#include "benchmark-registry.hpp"
+#include "../src/sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar sort_benchmark{"sort", [](auto low, auto high) { bork_lib::sort(low, high); }};
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "benchmark-registry.hpp"
+#include "../src/merge-sort.hpp"
+#include "../src/quicksort-hoare.hpp"
+#include "../src/sorting-network.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar quicksort_hoare_network_benchmark{"quicksort_hoare_network", [](auto low, auto high) {
+    quicksort_hoare<decltype(low), PartitionScheme::classic, NetworkLeafSort>(low, high);
+}};
+static const SortRegistrar buffered_merge_sort_network_benchmark{"buffered_merge_sort_network",
+    [](auto low, auto high) { buffered_merge_sort<decltype(low), NetworkLeafSort>(low, high); }};
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include <string>
+#include "benchmark-registry.hpp"
+#include "../src/string-sort.hpp"
+
+using namespace bork_lib;
+
+static const SortRegistrar multikey_quicksort_benchmark{"multikey_quicksort",
+    [](auto low, auto high) { multikey_quicksort(low, high); }, TypeList<std::string>{}};
+static const SortRegistrar cached_multikey_quicksort_benchmark{"cached_multikey_quicksort",
+    [](auto low, auto high) { cached_multikey_quicksort(low, high); }, TypeList<std::string>{}};
+static const SortRegistrar string_radix_sort_benchmark{"string_radix_sort",
+    [](auto low, auto high) { string_radix_sort(low, high); }, TypeList<std::string>{}};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../catch/catch.hpp"
+#include "../src/parallel-merge-sort.hpp"
+
+using bork_lib::parallel_merge_sort;
+using bork_lib::ThreadPool;
+
+std::random_device rd{};
+
+std::vector<std::string> create_strings(int size)
+{
+    std::mt19937 mt{rd()};
+    std::uniform_int_distribution<> dist{0, size / 4};
+    std::vector<std::string> vec;
+    for (int i = 0; i < size; ++i) {
+        vec.push_back("a string too long for the small string buffer " + std::to_string(dist(mt)));
+    }
+
+    return vec;
+}
+
+TEST_CASE("Parallel merge sort sorts ints like a stable sort", "[parallel_merge_sort]")
+{
+    std::mt19937 mt{rd()};
+    std::uniform_int_distribution<> dist{0, 1000};
+    std::vector<int> vec(200000);
+    for (auto& x : vec) {
+        x = dist(mt);
+    }
+    auto expected = vec;
+    std::stable_sort(expected.begin(), expected.end());
+
+    ThreadPool pool{4};
+    parallel_merge_sort(vec.begin(), vec.end(), pool);
+    REQUIRE(vec == expected);
+}
+
+TEST_CASE("Parallel merge sort keeps strings intact when merging in parallel", "[parallel_merge_sort]")
+{
+    // well above parallel_merge_cutoff, so the top merges are split across the workers
+    auto vec = create_strings(200000);
+    auto expected = vec;
+    std::stable_sort(expected.begin(), expected.end());
+
+    ThreadPool pool{4};
+    parallel_merge_sort(vec.begin(), vec.end(), pool);
+    REQUIRE(vec == expected);
+}
+
+TEST_CASE("Parallel merge sort handles tiny ranges", "[parallel_merge_sort]")
+{
+    ThreadPool pool{4};
+    std::vector<std::string> empty;
+    parallel_merge_sort(empty.begin(), empty.end(), pool);
+    REQUIRE(empty.empty());
+
+    std::vector<std::string> single{"x"};
+    parallel_merge_sort(single.begin(), single.end(), pool);
+    REQUIRE(single == std::vector<std::string>{"x"});
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include "../../catch/catch.hpp"
+#include "../src/parallel-quicksort.hpp"
+
+using bork_lib::parallel_partition;
+using bork_lib::parallel_partition_block;
+using bork_lib::parallel_quicksort;
+using bork_lib::ThreadPool;
+
+std::random_device rd{};
+
+/* Returns blocks of parallel_partition_block elements that are each entirely below the
+ * threshold, entirely above it, or mixed, so that some blocks left of the global split
+ * need no swaps at all and some right of it neither. */
+std::vector<int> create_block_layout(std::size_t num_blocks, std::mt19937& mt)
+{
+    std::uniform_int_distribution<> kind_dist{0, 2};
+    std::uniform_int_distribution<> value_dist{0, 999};
+    std::vector<int> vec;
+    for (std::size_t b = 0; b < num_blocks; ++b) {
+        auto kind = kind_dist(mt);
+        for (std::ptrdiff_t i = 0; i < parallel_partition_block; ++i) {
+            auto value = value_dist(mt);
+            vec.push_back(kind == 0 ? value % 500 : kind == 1 ? 500 + value % 500 : value);
+        }
+    }
+
+    return vec;
+}
+
+TEST_CASE("Parallel partition splits blocks that are entirely on one side", "[parallel_quicksort]")
+{
+    std::mt19937 mt{rd()};
+    ThreadPool pool{8};
+    auto pred = [](int x) { return x < 500; };
+    for (int round = 0; round < 20; ++round) {
+        auto vec = create_block_layout(8, mt);
+        auto expected_left = std::count_if(vec.begin(), vec.end(), pred);
+        auto mid = parallel_partition(vec.begin(), vec.end(), pred, pool);
+        REQUIRE(mid - vec.begin() == expected_left);
+        REQUIRE(std::is_partitioned(vec.begin(), vec.end(), pred));
+    }
+}
+
+TEST_CASE("Parallel quicksort sorts a large nearly sorted input", "[parallel_quicksort]")
+{
+    std::mt19937 mt{rd()};
+    std::vector<int> vec(1 << 22);
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = static_cast<int>(i);
+    }
+    std::uniform_int_distribution<std::size_t> index_dist{0, vec.size() - 1};
+    for (int i = 0; i < 1000; ++i) {
+        std::swap(vec[index_dist(mt)], vec[index_dist(mt)]);
+    }
+    auto expected = vec;
+    std::sort(expected.begin(), expected.end());
+
+    ThreadPool pool{8};
+    parallel_quicksort(vec.begin(), vec.end(), pool);
+    REQUIRE(vec == expected);
+}
+
+TEST_CASE("Parallel quicksort sorts random input", "[parallel_quicksort]")
+{
+    std::mt19937 mt{rd()};
+    std::uniform_int_distribution<> dist{0, 1000};
+    std::vector<int> vec(1 << 22);
+    for (auto& x : vec) {
+        x = dist(mt);
+    }
+    auto expected = vec;
+    std::sort(expected.begin(), expected.end());
+
+    ThreadPool pool{8};
+    parallel_quicksort(vec.begin(), vec.end(), pool);
+    REQUIRE(vec == expected);
+}
\ No newline at end of file
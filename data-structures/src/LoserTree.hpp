@@ -0,0 +1,159 @@
+#ifndef LOSERTREE_HPP
+#define LOSERTREE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace bork_lib
+{
+
+/* A tournament tree of losers over k sources, used for k-way merging. Every internal node
+ * stores the source that lost the match played there, and the overall winner is kept
+ * separately, so replacing the winner replays only the log(k) matches on its leaf-to-root
+ * path with one comparison each. Ties go to the source with the lower index, which makes
+ * merges stable. */
+template<typename T, typename Compare = std::less<T>>
+class LoserTree
+{
+private:
+    std::size_t k;
+    std::vector<T> values;
+    std::vector<char> exhausted;
+    std::vector<std::size_t> losers;   // losers[0] holds the winner
+    std::size_t live;
+    Compare comp;
+    bool beats(std::size_t a, std::size_t b) const;
+    std::size_t build_subtree(std::size_t node);
+    void replay(std::size_t source);
+
+public:
+    explicit LoserTree(std::size_t k, Compare comp = Compare{});
+    void set(std::size_t source, T value);
+    void build();
+    const T& top() const;
+    std::size_t top_source() const noexcept { return losers[0]; }
+    void replace_top(T value);
+    void pop_top();
+    std::size_t size() const noexcept { return k; }
+    bool empty() const noexcept { return live == 0; }
+};
+
+/* Private function that returns whether source a wins against source b. */
+template<typename T, typename Compare>
+bool LoserTree<T, Compare>::beats(std::size_t a, std::size_t b) const
+{
+    if (exhausted[a]) {
+        return false;
+    }
+    if (exhausted[b]) {
+        return true;
+    }
+    // one comparison decides the match, since ties go to the lower source: the operands
+    // are swapped rather than branched on, as the outcome is unpredictable when merging
+    bool flip = a < b;
+    auto x = flip ? b : a;
+    auto y = flip ? a : b;
+    return comp(values[x], values[y]) != flip;
+}
+
+/* Private function that plays all matches below a node and returns the winner. */
+template<typename T, typename Compare>
+std::size_t LoserTree<T, Compare>::build_subtree(std::size_t node)
+{
+    if (node >= k) {
+        return node - k;
+    }
+
+    auto left = build_subtree(2 * node);
+    auto right = build_subtree(2 * node + 1);
+    if (beats(left, right)) {
+        losers[node] = right;
+        return left;
+    }
+    losers[node] = left;
+    return right;
+}
+
+/* Private function that replays the matches from a source's leaf up to the root. */
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::replay(std::size_t source)
+{
+    auto winner = source;
+    for (auto node = (source + k) / 2; node > 0; node /= 2) {
+        auto loser = losers[node];
+        bool swap = beats(loser, winner);
+        losers[node] = swap ? winner : loser;
+        winner = swap ? loser : winner;
+    }
+    losers[0] = winner;
+}
+
+/* Constructor. All k sources start out exhausted. */
+template<typename T, typename Compare>
+LoserTree<T, Compare>::LoserTree(std::size_t k, Compare comp)
+  : k{k}, values(k), exhausted(k, 1), losers(k == 0 ? 1 : k, 0), live{0}, comp{std::move(comp)}
+{
+}
+
+/* Sets the first value of a source. Call build() once all sources are set. */
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::set(std::size_t source, T value)
+{
+    if (source >= k) {
+        throw std::out_of_range("Invalid source.");
+    }
+
+    values[source] = std::move(value);
+    if (exhausted[source]) {
+        exhausted[source] = 0;
+        ++live;
+    }
+}
+
+/* Plays the initial tournament. */
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::build()
+{
+    if (k > 0) {
+        losers[0] = build_subtree(1);
+    }
+}
+
+/* Returns the smallest current value. */
+template<typename T, typename Compare>
+const T& LoserTree<T, Compare>::top() const
+{
+    if (empty()) {
+        throw std::out_of_range("Loser tree is empty.");
+    }
+
+    return values[losers[0]];
+}
+
+/* Replaces the smallest value with the next value from the same source. */
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::replace_top(T value)
+{
+    values[losers[0]] = std::move(value);
+    replay(losers[0]);
+}
+
+/* Removes the smallest value when its source has nothing left. */
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::pop_top()
+{
+    if (empty()) {
+        throw std::out_of_range("Loser tree is empty.");
+    }
+
+    exhausted[losers[0]] = 1;
+    --live;
+    replay(losers[0]);
+}
+
+}  // end namespace
+
+#endif
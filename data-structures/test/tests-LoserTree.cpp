@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../../catch/catch.hpp"
+#include "../src/LoserTree.hpp"
+
+using bork_lib::LoserTree;
+
+std::random_device rd{};
+
+std::vector<std::vector<int>> create_sorted_sources(std::size_t num_sources, int max_length)
+{
+    std::mt19937 mt{rd()};
+    std::uniform_int_distribution<> length_dist{0, max_length};
+    std::uniform_int_distribution<> value_dist{0, 100};
+    std::vector<std::vector<int>> sources(num_sources);
+    for (auto& source : sources) {
+        auto length = length_dist(mt);
+        for (int i = 0; i < length; ++i) {
+            source.push_back(value_dist(mt));
+        }
+        std::sort(source.begin(), source.end());
+    }
+
+    return sources;
+}
+
+template<typename Compare = std::less<int>>
+std::vector<std::pair<int, std::size_t>> merge_sources(const std::vector<std::vector<int>>& sources,
+                                                       Compare comp = Compare{})
+{
+    LoserTree<int, Compare> tree{sources.size(), comp};
+    std::vector<std::size_t> positions(sources.size(), 0);
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        if (!sources[i].empty()) {
+            tree.set(i, sources[i][0]);
+        }
+    }
+    tree.build();
+
+    std::vector<std::pair<int, std::size_t>> merged;
+    while (!tree.empty()) {
+        auto source = tree.top_source();
+        merged.emplace_back(tree.top(), source);
+        if (++positions[source] < sources[source].size()) {
+            tree.replace_top(sources[source][positions[source]]);
+        } else {
+            tree.pop_top();
+        }
+    }
+
+    return merged;
+}
+
+TEST_CASE("LoserTree can be constructed", "[LoserTree]")
+{
+    LoserTree<int> tree{4};
+    REQUIRE(tree.size() == 4);
+    REQUIRE(tree.empty());
+
+    LoserTree<int> empty_tree{0};
+    empty_tree.build();
+    REQUIRE(empty_tree.empty());
+    REQUIRE_THROWS_AS(empty_tree.top(), std::out_of_range);
+}
+
+TEST_CASE("LoserTree merges sorted sources", "[LoserTree]")
+{
+    for (std::size_t num_sources : {1, 2, 3, 7, 8, 33}) {
+        auto sources = create_sorted_sources(num_sources, 50);
+        auto merged = merge_sources(sources);
+
+        std::vector<int> expected;
+        for (const auto& source : sources) {
+            expected.insert(expected.end(), source.begin(), source.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        REQUIRE(merged.size() == expected.size());
+        for (std::size_t i = 0; i < merged.size(); ++i) {
+            REQUIRE(merged[i].first == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("LoserTree breaks ties in favor of the lower source", "[LoserTree]")
+{
+    auto sources = create_sorted_sources(9, 30);
+    auto merged = merge_sources(sources);
+    for (std::size_t i = 1; i < merged.size(); ++i) {
+        if (merged[i - 1].first == merged[i].first) {
+            REQUIRE(merged[i - 1].second <= merged[i].second);
+        }
+    }
+}
+
+TEST_CASE("LoserTree accepts a custom comparator", "[LoserTree]")
+{
+    auto sources = create_sorted_sources(5, 40);
+    for (auto& source : sources) {
+        std::reverse(source.begin(), source.end());
+    }
+
+    auto merged = merge_sources(sources, std::greater<int>{});
+    REQUIRE(std::is_sorted(merged.begin(), merged.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+    }));
+}
+
+TEST_CASE("LoserTree rejects invalid sources", "[LoserTree]")
+{
+    LoserTree<int> tree{3};
+    REQUIRE_THROWS_AS(tree.set(3, 1), std::out_of_range);
+}
\ No newline at end of file